@@ -0,0 +1,80 @@
+#include "../b-index.h"
+
+namespace {
+
+// Fills an arena until it owns blockCount blocks. The time per allocation should not depend on how many blocks the
+// arena already owns.
+addr_size arenaAllocUntilBlockCount(addr_size blockCount) {
+    constexpr addr_size BLOCK_SIZE = core::CORE_KILOBYTE * 4;
+    constexpr addr_size ALLOC_SIZE = 64;
+    constexpr addr_size ALLOCS_PER_BLOCK = BLOCK_SIZE / ALLOC_SIZE;
+
+    core::StdArenaAllocator arena(BLOCK_SIZE);
+    defer { arena.clear(); };
+
+    addr_size ops = blockCount * ALLOCS_PER_BLOCK;
+    for (addr_size i = 0; i < ops; i++) {
+        void* p = arena.alloc(ALLOC_SIZE, sizeof(u8));
+        benchDoNotOptimize(p);
+    }
+
+    return ops;
+}
+
+// Same as above, but every allocation leaves a hole at the end of its block, which is the worst case for the
+// partially-free block list.
+addr_size arenaAllocWithHolesUntilBlockCount(addr_size blockCount) {
+    constexpr addr_size BLOCK_SIZE = core::CORE_KILOBYTE * 4;
+    constexpr addr_size ALLOC_SIZE = BLOCK_SIZE / 2 + 8;
+
+    core::StdArenaAllocator arena(BLOCK_SIZE);
+    defer { arena.clear(); };
+
+    for (addr_size i = 0; i < blockCount; i++) {
+        void* p = arena.alloc(ALLOC_SIZE, sizeof(u8));
+        benchDoNotOptimize(p);
+    }
+
+    return blockCount;
+}
+
+// Reuses the blocks owned by the arena after a reset.
+addr_size arenaResetAndRefill(addr_size blockCount) {
+    constexpr addr_size BLOCK_SIZE = core::CORE_KILOBYTE * 4;
+    constexpr addr_size ALLOC_SIZE = 64;
+    constexpr addr_size ALLOCS_PER_BLOCK = BLOCK_SIZE / ALLOC_SIZE;
+    constexpr addr_size ROUNDS = 4;
+
+    core::StdArenaAllocator arena(BLOCK_SIZE);
+    defer { arena.clear(); };
+
+    addr_size ops = 0;
+    for (addr_size r = 0; r < ROUNDS; r++) {
+        arena.reset();
+        for (addr_size i = 0; i < blockCount * ALLOCS_PER_BLOCK; i++) {
+            void* p = arena.alloc(ALLOC_SIZE, sizeof(u8));
+            benchDoNotOptimize(p);
+            ops++;
+        }
+    }
+
+    return ops;
+}
+
+} // namespace
+
+void runArenaAllocatorBenchmarksSuite() {
+    beginBenchmarkSuite(FN_NAME_TO_CPTR(runArenaAllocatorBenchmarksSuite));
+
+    runBenchmark("arena alloc, 64 blocks",    []() { return arenaAllocUntilBlockCount(64); });
+    runBenchmark("arena alloc, 1024 blocks",  []() { return arenaAllocUntilBlockCount(1024); });
+    runBenchmark("arena alloc, 16384 blocks", []() { return arenaAllocUntilBlockCount(16384); });
+
+    runBenchmark("arena alloc with holes, 64 blocks",    []() { return arenaAllocWithHolesUntilBlockCount(64); });
+    runBenchmark("arena alloc with holes, 1024 blocks",  []() { return arenaAllocWithHolesUntilBlockCount(1024); });
+    runBenchmark("arena alloc with holes, 16384 blocks", []() { return arenaAllocWithHolesUntilBlockCount(16384); });
+
+    runBenchmark("arena reset and refill, 64 blocks",    []() { return arenaResetAndRefill(64); });
+    runBenchmark("arena reset and refill, 1024 blocks",  []() { return arenaResetAndRefill(1024); });
+    runBenchmark("arena reset and refill, 16384 blocks", []() { return arenaResetAndRefill(16384); });
+}
@@ -0,0 +1,117 @@
+#include "../b-index.h"
+
+#include <thread>
+
+namespace {
+
+constexpr addr_size BATCH_SIZE = 256;
+
+inline addr_size benchAllocSize(addr_size i) {
+    return 16 + (i * 37) % 1024;
+}
+
+// Allocates a batch of mixed size blocks and frees them again, all on the same thread.
+template <typename TAllocator>
+addr_size allocFreeBatches(TAllocator& allocator, addr_size rounds) {
+    void* ptrs[BATCH_SIZE];
+
+    for (addr_size r = 0; r < rounds; r++) {
+        for (addr_size i = 0; i < BATCH_SIZE; i++) {
+            ptrs[i] = allocator.alloc(benchAllocSize(i), sizeof(u8));
+            benchDoNotOptimize(ptrs[i]);
+        }
+        for (addr_size i = 0; i < BATCH_SIZE; i++) {
+            allocator.free(ptrs[i], benchAllocSize(i), sizeof(u8));
+        }
+    }
+
+    return rounds * BATCH_SIZE;
+}
+
+template <typename TAllocator>
+struct PipelineChannel {
+    static constexpr addr_size RING_SIZE = 256;
+
+    core::AtomicPtr ring[RING_SIZE];
+    TAllocator* allocator;
+    addr_size itemCount;
+};
+
+// Every producer allocates blocks which its consumer frees on another thread.
+template <typename TAllocator>
+addr_size producerConsumerPipeline(TAllocator& allocator, addr_size pairCount, addr_size itemCount) {
+    using Channel = PipelineChannel<TAllocator>;
+    constexpr addr_size MAX_PAIRS = 8;
+    Panic(pairCount <= MAX_PAIRS);
+
+    Channel channels[MAX_PAIRS];
+    core::Thread producers[MAX_PAIRS];
+    core::Thread consumers[MAX_PAIRS];
+
+    for (addr_size i = 0; i < pairCount; i++) {
+        for (addr_size j = 0; j < Channel::RING_SIZE; j++) {
+            channels[i].ring[j].store(nullptr);
+        }
+        channels[i].allocator = &allocator;
+        channels[i].itemCount = itemCount;
+
+        Expect(core::threadInit(producers[i]));
+        Expect(core::threadInit(consumers[i]));
+
+        Expect(core::threadStart(consumers[i], &channels[i], [](void* arg) {
+            Channel& ch = *reinterpret_cast<Channel*>(arg);
+            for (addr_size item = 0; item < ch.itemCount; item++) {
+                core::AtomicPtr& slot = ch.ring[item % Channel::RING_SIZE];
+                void* ptr;
+                while ((ptr = slot.load(std::memory_order_acquire)) == nullptr) {
+                    std::this_thread::yield();
+                }
+                slot.store(nullptr, std::memory_order_release);
+                ch.allocator->free(ptr, benchAllocSize(item), sizeof(u8));
+            }
+        }));
+
+        Expect(core::threadStart(producers[i], &channels[i], [](void* arg) {
+            Channel& ch = *reinterpret_cast<Channel*>(arg);
+            for (addr_size item = 0; item < ch.itemCount; item++) {
+                void* ptr = ch.allocator->alloc(benchAllocSize(item), sizeof(u8));
+                Panic(ptr != nullptr, "Out of memory");
+
+                core::AtomicPtr& slot = ch.ring[item % Channel::RING_SIZE];
+                while (slot.load(std::memory_order_acquire) != nullptr) {
+                    std::this_thread::yield();
+                }
+                slot.store(ptr, std::memory_order_release);
+            }
+        }));
+    }
+
+    for (addr_size i = 0; i < pairCount; i++) {
+        Expect(core::threadJoin(producers[i]));
+        Expect(core::threadJoin(consumers[i]));
+    }
+
+    return pairCount * itemCount;
+}
+
+} // namespace
+
+void runThreadCachingAllocatorBenchmarksSuite() {
+    beginBenchmarkSuite(FN_NAME_TO_CPTR(runThreadCachingAllocatorBenchmarksSuite));
+
+    core::StdAllocator stdAllocator;
+    core::ThreadCachingAllocator tcAllocator;
+    defer { tcAllocator.clear(); };
+
+    constexpr addr_size ROUNDS = 4096;
+    constexpr addr_size ITEMS = 200000;
+
+    runBenchmark("std alloc/free batches, 1 thread",            [&]() { return allocFreeBatches(stdAllocator, ROUNDS); });
+    runBenchmark("thread caching alloc/free batches, 1 thread", [&]() { return allocFreeBatches(tcAllocator, ROUNDS); });
+
+    runBenchmark("std producer/consumer, 1 pair",            [&]() { return producerConsumerPipeline(stdAllocator, 1, ITEMS); });
+    runBenchmark("thread caching producer/consumer, 1 pair", [&]() { return producerConsumerPipeline(tcAllocator, 1, ITEMS); });
+
+    runBenchmark("std producer/consumer, 4 pairs",            [&]() { return producerConsumerPipeline(stdAllocator, 4, ITEMS); });
+    runBenchmark("thread caching producer/consumer, 4 pairs", [&]() { return producerConsumerPipeline(tcAllocator, 4, ITEMS); });
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <core.h>
+#include <core.h> // If pragma once is omitted somewhere in the core library, this will catch it.
+
+#include <core_extensions/hash_functions.h>
+
+#include <iostream>
+
+using namespace coretypes;
+
+// #################### BENCHMARK HELPERS ##############################################################################
+
+inline volatile u8 g_benchSink = 0;
+
+// Prevents the compiler from optimizing away the computation of value.
+template <typename T>
+inline void benchDoNotOptimize(const T& value) {
+#if COMPILER_MSVC == 1
+    g_benchSink = *reinterpret_cast<const volatile u8*>(&value);
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
+
+/**
+ * \brief Runs a single benchmark and prints the elapsed time.
+ *
+ * \param name The name of the benchmark.
+ * \param fn A function that takes no arguments and returns the number of operations it executed.
+*/
+template <typename TFunc>
+inline void runBenchmark(const char* name, TFunc fn) {
+    u64 start = core::getMonotonicNowNs();
+    addr_size ops = fn();
+    u64 elapsed = core::getMonotonicNowNs() - start;
+
+    char timeBuff[core::testing::ELAPSED_TIME_TO_STR_BUFFER_SIZE];
+    std::cout << "\t[BENCH] " << name
+              << " [ ops: " << ops
+              << ", time: " << core::testing::elapsedTimeToStr(timeBuff, elapsed)
+              << ", ns/op: " << (ops > 0 ? f64(elapsed) / f64(ops) : 0.0)
+              << " ]" << std::endl;
+}
+
+inline void beginBenchmarkSuite(const char* name) {
+    std::cout << "[BENCH SUITE] " << name << std::endl;
+}
+
+// ##################### BENCHMARK SUITES ##############################################################################
+
+void runArenaAllocatorBenchmarksSuite();
+void runThreadCachingAllocatorBenchmarksSuite();
+
+void runAllBenchmarks();
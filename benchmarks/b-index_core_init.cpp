@@ -0,0 +1,35 @@
+#include "b-index.h"
+
+namespace {
+
+void assertHandler(const char* failedExpr, const char* file, i32 line, const char* funcName, const char* errMsg) {
+    std::cout << ANSI_RED_START() << ANSI_BOLD_START()
+                << "[ASSERTION]:\n  [EXPR]: " << failedExpr
+                << "\n  [FUNC]: " << funcName
+                << "\n  [FILE]: " << file << ":" << line
+                << "\n  [MSG]: " << (errMsg ? errMsg : "") // IMPORTANT: MSVC's std implementation will crash if errMsg is nullptr !
+                << ANSI_RESET()
+                << std::endl;
+
+    throw std::runtime_error("Assertion failed!");
+}
+
+void coreInit() {
+    core::initProgramCtx(assertHandler, nullptr);
+}
+
+void coreShutdown() {
+    core::destroyProgramCtx();
+}
+
+} // namespace
+
+void runAllBenchmarks() {
+    coreInit();
+    defer { coreShutdown(); };
+
+    std::cout << "\n" << "RUNNING BENCHMARKS" << "\n\n";
+
+    runArenaAllocatorBenchmarksSuite();
+    runThreadCachingAllocatorBenchmarksSuite();
+}
@@ -0,0 +1,22 @@
+#include "benchmarks/b-index.h"
+
+#include <iostream>
+
+i32 main() {
+    std::cout << "[CORE VERSION] "
+              << CORE_VERSION_MAJOR << "."
+              << CORE_VERSION_MINOR << "."
+              << CORE_VERSION_PATCH
+              << std::endl;
+
+    if constexpr (CORE_DEBUG == 1) {
+        std::cout << "[MODE] DEBUG (benchmark results are not representative)"  << std::endl;
+    }
+    else {
+        std::cout << "[MODE] RELEASE" << std::endl;
+    }
+
+    runAllBenchmarks();
+
+    return 0;
+}
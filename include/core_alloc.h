@@ -7,8 +7,6 @@
 
 #include <plt/core_atomics.h>
 
-// TODO2: I need to think about alignment in these allocators. Aligning every allocation to 8 bytes might not be the best idea for all cases.
-
 namespace core {
 
 using namespace coretypes;
@@ -17,13 +15,33 @@ using OOMHandlerFn = void (*)();
 
 CORE_API_EXPORT OOMHandlerFn getDefaultOOMHandler();
 
+/**
+ * @brief The alignment of memory returned by alloc, calloc and realloc.
+*/
+constexpr addr_size DEFAULT_ALLOC_ALIGNMENT = sizeof(addr_size);
+
+/**
+ * @brief The strictest alignment of any scalar type.
+*/
+constexpr addr_size MAX_FUNDAMENTAL_ALIGNMENT = alignof(max_align_t);
+
+/**
+ * @brief alloc returns memory aligned to at least DEFAULT_ALLOC_ALIGNMENT. allocAligned accepts any power of two
+ *        alignment up to the page size.
+ *
+ * @note Aligned requests which do not exceed MAX_FUNDAMENTAL_ALIGNMENT behave exactly like alloc/free, so the two can
+ *       be mixed. Memory which was requested with a larger alignment must be released with freeAligned, passing the
+ *       same alignment.
+*/
 template <typename T>
 concept AllocatorConcept = requires(T a) {
     { a.alloc(std::declval<addr_size>(), std::declval<addr_size>()) } -> core::same_as<void*>;
+    { a.allocAligned(std::declval<addr_size>(), std::declval<addr_size>(), std::declval<addr_size>()) } -> core::same_as<void*>;
     { a.calloc(std::declval<addr_size>(), std::declval<addr_size>()) } -> core::same_as<void*>;
     { a.realloc(std::declval<void*>(), std::declval<addr_size>(), std::declval<addr_size>(), std::declval<addr_size>(), std::declval<addr_size>()) } -> core::same_as<void*>;
     { a.clear() };
     { a.free(std::declval<void*>(), std::declval<addr_size>(), std::declval<addr_size>()) };
+    { a.freeAligned(std::declval<void*>(), std::declval<addr_size>(), std::declval<addr_size>(), std::declval<addr_size>()) };
     { a.totalMemoryAllocated() } -> core::same_as<addr_size>;
     { a.inUseMemory() } -> core::same_as<addr_size>;
     { a.name() } -> core::same_as<const char*>;
@@ -31,7 +49,35 @@ concept AllocatorConcept = requires(T a) {
     { a.canDetectLeaks() } -> core::same_as<bool>;
 };
 
+/**
+ * @brief Opaque snapshot of a linear allocator's state. Restoring it releases everything that was allocated after it was
+ *        taken, in one step.
+ *
+ * @note Checkpoints must be restored in the reverse order in which they were saved. A clear or reset invalidates all
+ *       outstanding checkpoints.
+*/
+struct AllocatorCheckpoint {
+    static constexpr addr_size DATA_SIZE = 12;
+    addr_size data[DATA_SIZE];
+};
+
+/**
+ * @brief Allocators which can roll back to a previously saved state.
+*/
+template <typename T>
+concept CheckpointAllocatorConcept = AllocatorConcept<T> && requires(T a) {
+    { a.saveCheckpoint() } -> core::same_as<AllocatorCheckpoint>;
+    { a.restoreCheckpoint(std::declval<const AllocatorCheckpoint&>()) };
+};
+
 struct ArenaBlock;
+struct ArenaOversizedBlock;
+struct PoolSlab;
+struct PoolLargeBlock;
+struct ThreadCache;
+struct ThreadCacheSlab;
+struct ThreadCacheLargeBlock;
+struct TracedAllocation;
 
 struct CORE_API_EXPORT StdAllocator;
 struct                 StdStatsAllocator;
@@ -39,6 +85,39 @@ struct CORE_API_EXPORT BumpAllocator;
 struct CORE_API_EXPORT ThreadLocalStdArenaAllocator;
 struct CORE_API_EXPORT ThreadLocalBumpAllocator;
 struct CORE_API_EXPORT StdArenaAllocator;
+struct CORE_API_EXPORT PoolAllocator;
+struct CORE_API_EXPORT VirtualArenaAllocator;
+struct                 ThreadCachingAllocator;
+struct                 AllocationTracer;
+
+namespace detail {
+
+/**
+ * @brief Book-keeping shared by StdArenaAllocator and ThreadLocalStdArenaAllocator.
+ *
+ * Allocations are bumped out of the block at `currBlockIdx`. When it runs out of space the cursor moves to the next
+ * block and, if the old one still has room, its index is remembered in `partialBlocks` so that smaller allocations can
+ * fill it later. Both lookups are bounded, which keeps allocation O(1) regardless of how many blocks the arena owns.
+ * The block table grows geometrically.
+ *
+ * Requests larger than the block size get a dedicated allocation which is linked in `oversizedBlocks` and released on
+ * reset or clear.
+*/
+struct ArenaState {
+    static constexpr addr_size PARTIAL_BLOCKS_MAX = 4;
+
+    ArenaBlock* blocks;
+    addr_size blockCount;
+    addr_size blockCap;
+    addr_size blockSize;
+    addr_size currBlockIdx;
+    addr_size partialBlocks[PARTIAL_BLOCKS_MAX];
+    addr_size partialCount;
+    ArenaOversizedBlock* oversizedBlocks;
+    addr_size oversizedBytes;
+};
+
+} // namespace detail
 
 struct CORE_API_EXPORT StdAllocator {
     OOMHandlerFn oomHandler = nullptr;
@@ -51,9 +130,11 @@ struct CORE_API_EXPORT StdAllocator {
     constexpr const char* name() { return "STD_ALLOCATOR"; }
 
     void* alloc(addr_size count, addr_size size);
+    void* allocAligned(addr_size count, addr_size size, addr_size alignment);
     void* calloc(addr_size count, addr_size size);
     void* realloc(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize);
     void free(void* ptr, addr_size count, addr_size size);
+    void freeAligned(void* ptr, addr_size count, addr_size size, addr_size alignment);
     void clear(); // does nothing
     addr_size totalMemoryAllocated(); // always returns 0
     addr_size inUseMemory(); // always returns 0
@@ -77,9 +158,11 @@ struct StdStatsAllocator {
     constexpr const char* name() { return "STD_STATS_ALLOCATOR"; }
 
     CORE_API_EXPORT void* alloc(addr_size count, addr_size size);
+    CORE_API_EXPORT void* allocAligned(addr_size count, addr_size size, addr_size alignment);
     CORE_API_EXPORT void* calloc(addr_size count, addr_size size);
     CORE_API_EXPORT void* realloc(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize);
     CORE_API_EXPORT void free(void* ptr, addr_size count, addr_size size);
+    CORE_API_EXPORT void freeAligned(void* ptr, addr_size count, addr_size size, addr_size alignment);
     CORE_API_EXPORT void clear();
     CORE_API_EXPORT addr_size totalMemoryAllocated();
     CORE_API_EXPORT addr_size inUseMemory();
@@ -110,9 +193,11 @@ struct CORE_API_EXPORT BumpAllocator {
     void setBuffer(void* data, addr_size cap);
 
     void* alloc(addr_size count, addr_size size);
+    void* allocAligned(addr_size count, addr_size size, addr_size alignment);
     void* calloc(addr_size count, addr_size size);
-    void* realloc(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize);
-    void free(void* ptr, addr_size count, addr_size size); // does nothing
+    void* realloc(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize); // the most recent allocation is resized in place
+    void free(void* ptr, addr_size count, addr_size size); // only releases the most recent allocation
+    void freeAligned(void* ptr, addr_size count, addr_size size, addr_size alignment); // only releases the most recent allocation
     void clear();
     addr_size totalMemoryAllocated(); // same as inUseMemory
     addr_size inUseMemory();
@@ -120,12 +205,15 @@ struct CORE_API_EXPORT BumpAllocator {
     constexpr bool tracksMemory() { return true; }
     constexpr bool canDetectLeaks() { return false; }
 
+    AllocatorCheckpoint saveCheckpoint();
+    void restoreCheckpoint(const AllocatorCheckpoint& checkpoint); // O(1)
+
 private:
     void* m_startAddr;
     void* m_currentAddr;
     addr_size m_cap;
 };
-static_assert(AllocatorConcept<BumpAllocator>);
+static_assert(CheckpointAllocatorConcept<BumpAllocator>);
 
 /**
  * @note This allocator is thread-safe only if the data pointer is thread-local.
@@ -147,9 +235,11 @@ struct CORE_API_EXPORT ThreadLocalBumpAllocator {
     void setBuffer(void* data, addr_size cap);
 
     void* alloc(addr_size count, addr_size size);
+    void* allocAligned(addr_size count, addr_size size, addr_size alignment);
     void* calloc(addr_size count, addr_size size);
-    void* realloc(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize);
-    void free(void* ptr, addr_size count, addr_size size); // does nothing
+    void* realloc(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize); // the most recent allocation is resized in place
+    void free(void* ptr, addr_size count, addr_size size); // only releases the most recent allocation
+    void freeAligned(void* ptr, addr_size count, addr_size size, addr_size alignment); // only releases the most recent allocation
     void clear();
     addr_size totalMemoryAllocated(); // same as inUseMemory
     addr_size inUseMemory();
@@ -157,10 +247,13 @@ struct CORE_API_EXPORT ThreadLocalBumpAllocator {
     constexpr bool tracksMemory() { return true; }
     constexpr bool canDetectLeaks() { return false; }
 
+    AllocatorCheckpoint saveCheckpoint();
+    void restoreCheckpoint(const AllocatorCheckpoint& checkpoint); // O(1)
+
 private:
     ThreadLocalBumpAllocator();
 };
-static_assert(AllocatorConcept<ThreadLocalBumpAllocator>);
+static_assert(CheckpointAllocatorConcept<ThreadLocalBumpAllocator>);
 
 /**
  * @note This allocator is not thread-safe.
@@ -181,9 +274,11 @@ struct CORE_API_EXPORT StdArenaAllocator {
     void setBlockSize(addr_size blockSize);
 
     void* alloc(addr_size count, addr_size size);
+    void* allocAligned(addr_size count, addr_size size, addr_size alignment);
     void* calloc(addr_size count, addr_size size);
-    void* realloc(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize);
-    void free(void* ptr, addr_size count, addr_size size); // does nothing
+    void* realloc(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize); // the most recent allocation of a block is resized in place
+    void free(void* ptr, addr_size count, addr_size size); // only releases the most recent allocation of a block
+    void freeAligned(void* ptr, addr_size count, addr_size size, addr_size alignment); // only releases the most recent allocation of a block
     void clear();
     addr_size totalMemoryAllocated();
     addr_size inUseMemory();
@@ -191,14 +286,18 @@ struct CORE_API_EXPORT StdArenaAllocator {
     constexpr bool tracksMemory() { return true; }
     constexpr bool canDetectLeaks() { return false; }
 
+    /**
+     * @brief Makes all blocks available for reuse without releasing them. Oversized allocations are released.
+    */
     void reset();
 
+    AllocatorCheckpoint saveCheckpoint();
+    void restoreCheckpoint(const AllocatorCheckpoint& checkpoint); // also releases oversized allocations made after the checkpoint
+
 private:
-    ArenaBlock* m_blocks;
-    addr_size m_blockCount;
-    addr_size m_blockSize;
+    detail::ArenaState m_state;
 };
-static_assert(AllocatorConcept<StdArenaAllocator>);
+static_assert(CheckpointAllocatorConcept<StdArenaAllocator>);
 
 /**
  * @note This allocator is thread-safe only if the data pointer is thread-local.
@@ -220,9 +319,11 @@ struct CORE_API_EXPORT ThreadLocalStdArenaAllocator {
     void setBlockSize(addr_size blockSize);
 
     void* alloc(addr_size count, addr_size size);
+    void* allocAligned(addr_size count, addr_size size, addr_size alignment);
     void* calloc(addr_size count, addr_size size);
-    void* realloc(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize);
-    void free(void* ptr, addr_size count, addr_size size); // does nothing
+    void* realloc(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize); // the most recent allocation of a block is resized in place
+    void free(void* ptr, addr_size count, addr_size size); // only releases the most recent allocation of a block
+    void freeAligned(void* ptr, addr_size count, addr_size size, addr_size alignment); // only releases the most recent allocation of a block
     void clear();
     addr_size totalMemoryAllocated();
     addr_size inUseMemory();
@@ -230,11 +331,387 @@ struct CORE_API_EXPORT ThreadLocalStdArenaAllocator {
     constexpr bool tracksMemory() { return true; }
     constexpr bool canDetectLeaks() { return false; }
 
+    /**
+     * @brief Makes all blocks available for reuse without releasing them. Oversized allocations are released.
+    */
     void reset();
 
+    AllocatorCheckpoint saveCheckpoint();
+    void restoreCheckpoint(const AllocatorCheckpoint& checkpoint); // also releases oversized allocations made after the checkpoint
+
 private:
     ThreadLocalStdArenaAllocator();
 };
-static_assert(AllocatorConcept<ThreadLocalStdArenaAllocator>);
+static_assert(CheckpointAllocatorConcept<ThreadLocalStdArenaAllocator>);
+
+/**
+ * @brief Segregated free list allocator. Requests up to MAX_BLOCK_SIZE bytes are rounded up to a power of two size class
+ *        and served from slabs of pages obtained with allocPages. Freed blocks are pushed onto the free list of their
+ *        class and reused in O(1). Larger requests are mapped directly with allocPages and unmapped on free.
+ *        Blocks are aligned to their class size, up to 64 bytes. Requests for a stricter alignment get dedicated pages.
+ *
+ * @note This allocator is not thread-safe.
+*/
+struct CORE_API_EXPORT PoolAllocator {
+    static constexpr addr_size MIN_BLOCK_SIZE = 16;
+    static constexpr addr_size MAX_BLOCK_SIZE = 2048;
+    static constexpr addr_size SIZE_CLASS_COUNT = 8; // 16, 32, 64, 128, 256, 512, 1024, 2048
+    static constexpr addr_size DEFAULT_SLAB_PAGE_COUNT = 16;
+
+    OOMHandlerFn oomHandler = nullptr;
+
+    NO_COPY(PoolAllocator);
+
+    PoolAllocator();
+    explicit PoolAllocator(addr_size slabPageCount);
+    PoolAllocator(PoolAllocator&& other);
+
+    constexpr const char* name() { return "POOL_ALLOCATOR"; }
+
+    /**
+     * @note Setting the slab page count will force a clear operation.
+    */
+    void setSlabPageCount(addr_size slabPageCount);
+
+    void* alloc(addr_size count, addr_size size);
+    void* allocAligned(addr_size count, addr_size size, addr_size alignment);
+    void* calloc(addr_size count, addr_size size);
+    void* realloc(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize);
+    void free(void* ptr, addr_size count, addr_size size);
+    void freeAligned(void* ptr, addr_size count, addr_size size, addr_size alignment);
+    void clear(); // returns all slabs and large blocks to the OS
+    addr_size totalMemoryAllocated(); // bytes mapped from the OS
+    addr_size inUseMemory(); // bytes handed out, rounded up to the size class
+
+    constexpr bool tracksMemory() { return true; }
+    constexpr bool canDetectLeaks() { return true; }
+
+private:
+    void* allocLarge(addr_size size, addr_size dataOffset);
+    void freeLarge(void* ptr, addr_size size, addr_size dataOffset);
+
+    void* m_freeLists[SIZE_CLASS_COUNT];
+    void* m_carveCurr[SIZE_CLASS_COUNT];
+    void* m_carveEnd[SIZE_CLASS_COUNT];
+    PoolSlab* m_slabs;
+    PoolLargeBlock* m_largeBlocks;
+    addr_size m_slabPageCount;
+    addr_size m_pageSize;
+    addr_size m_totalMemoryAllocated;
+    addr_size m_inUseMemory;
+};
+static_assert(AllocatorConcept<PoolAllocator>);
+
+/**
+ * @brief Bump allocator over a single range of address space which is reserved on the first allocation and committed
+ *        page by page as the cursor advances. Allocations never move, so growing the most recent one never copies.
+ *
+ * @note This allocator is not thread-safe.
+*/
+struct CORE_API_EXPORT VirtualArenaAllocator {
+    static constexpr addr_size DEFAULT_RESERVE_SIZE = addr_size(CORE_GIGABYTE);
+    static constexpr addr_size COMMIT_PAGE_COUNT = 16; // minimum number of pages committed at once
+
+    OOMHandlerFn oomHandler = nullptr;
+
+    NO_COPY(VirtualArenaAllocator);
+
+    VirtualArenaAllocator();
+    explicit VirtualArenaAllocator(addr_size reserveSize);
+    VirtualArenaAllocator(VirtualArenaAllocator&& other);
+
+    constexpr const char* name() { return "VIRTUAL_ARENA_ALLOCATOR"; }
+
+    /**
+     * @note Setting the reserve size will force a clear operation.
+    */
+    void setReserveSize(addr_size reserveSize);
+
+    void* alloc(addr_size count, addr_size size);
+    void* allocAligned(addr_size count, addr_size size, addr_size alignment);
+    void* calloc(addr_size count, addr_size size);
+    void* realloc(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize); // the most recent allocation is resized in place
+    void free(void* ptr, addr_size count, addr_size size); // only releases the most recent allocation
+    void freeAligned(void* ptr, addr_size count, addr_size size, addr_size alignment); // only releases the most recent allocation
+    void clear(); // releases the whole reservation
+    addr_size totalMemoryAllocated(); // committed bytes
+    addr_size inUseMemory();
+
+    constexpr bool tracksMemory() { return true; }
+    constexpr bool canDetectLeaks() { return false; }
+
+    /**
+     * @brief Moves the cursor back to the start of the reservation. Committed memory above `keepCommitted` bytes is
+     *        returned to the OS, the rest stays committed for reuse.
+    */
+    void reset(addr_size keepCommitted = core::limitMax<addr_size>());
+
+    AllocatorCheckpoint saveCheckpoint();
+    void restoreCheckpoint(const AllocatorCheckpoint& checkpoint); // O(1), keeps the memory committed
+
+private:
+    bool reserve();
+    bool ensureCommitted(addr_size byteLen);
+    bool isLastAllocation(const void* ptr, addr_size byteLen);
+
+    void* m_base;
+    void* m_curr;
+    addr_size m_reserveSize;
+    addr_size m_committed;
+    addr_size m_pageSize;
+};
+static_assert(CheckpointAllocatorConcept<VirtualArenaAllocator>);
+
+/**
+ * @brief Thread-safe allocator for memory which is allocated on one thread and freed on another.
+ *
+ * Every thread gets its own cache with a free list per size class, so allocating and freeing on the owning thread does
+ * not touch any shared state. Blocks freed by other threads are pushed onto a lock-free list in the owning cache, which
+ * the owner takes over with a single exchange once its local list runs dry. Caches refill from a shared range of address
+ * space that is reserved up front and committed one slab at a time. The size classes are the same as in the
+ * PoolAllocator. Larger requests are mapped directly with allocPages.
+ *
+ * When a thread exits its cache, together with the blocks cached in it, is handed to the next thread that needs one.
+ *
+ * @note clear must not run concurrently with any other call. At most MAX_LIVE_INSTANCES allocators can hold memory at
+ *       the same time.
+*/
+struct ThreadCachingAllocator {
+    // NOTE: This type exports functions instead of the whole struct for the same reason as the StdStatsAllocator.
+
+    static constexpr addr_size MIN_BLOCK_SIZE = 16;
+    static constexpr addr_size MAX_BLOCK_SIZE = 2048;
+    static constexpr addr_size SIZE_CLASS_COUNT = 8; // 16, 32, 64, 128, 256, 512, 1024, 2048
+    static constexpr addr_size SLAB_SIZE = addr_size(64 * CORE_KILOBYTE);
+    static constexpr addr_size DEFAULT_RESERVE_SIZE = addr_size(CORE_GIGABYTE);
+    static constexpr addr_size MAX_LIVE_INSTANCES = 16;
+
+    OOMHandlerFn oomHandler = nullptr;
+
+    NO_COPY(ThreadCachingAllocator);
+    NO_MOVE(ThreadCachingAllocator);
+
+    CORE_API_EXPORT ThreadCachingAllocator();
+    CORE_API_EXPORT explicit ThreadCachingAllocator(addr_size reserveSize);
+
+    constexpr const char* name() { return "THREAD_CACHING_ALLOCATOR"; }
+
+    /**
+     * @note Setting the reserve size will force a clear operation.
+    */
+    CORE_API_EXPORT void setReserveSize(addr_size reserveSize);
+
+    CORE_API_EXPORT void* alloc(addr_size count, addr_size size);
+    CORE_API_EXPORT void* allocAligned(addr_size count, addr_size size, addr_size alignment);
+    CORE_API_EXPORT void* calloc(addr_size count, addr_size size);
+    CORE_API_EXPORT void* realloc(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize);
+    CORE_API_EXPORT void free(void* ptr, addr_size count, addr_size size); // may be called from any thread
+    CORE_API_EXPORT void freeAligned(void* ptr, addr_size count, addr_size size, addr_size alignment); // may be called from any thread
+    CORE_API_EXPORT void clear(); // returns everything to the OS, not thread-safe
+    CORE_API_EXPORT addr_size totalMemoryAllocated(); // bytes committed from the OS
+    CORE_API_EXPORT addr_size inUseMemory(); // bytes handed out, rounded up to the size class
+
+    constexpr bool tracksMemory() { return true; }
+    constexpr bool canDetectLeaks() { return true; }
+
+private:
+    bool ensureInitialized();
+    bool initialize();
+    ThreadCache* getCache();
+    ThreadCache* acquireCache();
+    void* allocSmall(ThreadCache& cache, addr_size classIdx);
+    void freeSmall(void* ptr, addr_size classIdx);
+    void* allocLarge(addr_size size, addr_size dataOffset);
+    void freeLarge(void* ptr, addr_size size, addr_size dataOffset);
+    void lockLargeBlocks();
+    void unlockLargeBlocks();
+
+    core::AtomicU32 m_state;
+    u32 m_slot;
+    u64 m_epoch;
+    addr_size m_reserveSize;
+    addr_size m_pageSize;
+    addr_size m_slabCount;
+    void* m_slabsBase;
+    ThreadCacheSlab* m_slabs;
+    core::AtomicU64 m_nextSlab;
+    core::AtomicPtr m_caches;
+    core::AtomicBool m_largeBlocksLock;
+    ThreadCacheLargeBlock* m_largeBlocks;
+    core::AtomicU64 m_largeInUseMemory;
+    core::AtomicU64 m_totalMemoryAllocated;
+};
+static_assert(AllocatorConcept<ThreadCachingAllocator>);
+
+/**
+ * @brief Sets the tag which the allocation tracers on the calling thread attribute allocations to. Passing nullptr falls
+ *        back to stack traces. Returns the previous tag.
+ *
+ * @note The tag is not copied, it has to outlive every tracer that records it. String literals are the intended use.
+*/
+CORE_API_EXPORT const char* setAllocationTag(const char* tag);
+
+struct AllocationTagScope {
+    NO_COPY(AllocationTagScope);
+    NO_MOVE(AllocationTagScope);
+
+    explicit AllocationTagScope(const char* tag) : m_prevTag(setAllocationTag(tag)) {}
+    ~AllocationTagScope() { setAllocationTag(m_prevTag); }
+
+private:
+    const char* m_prevTag;
+};
+
+struct AllocationSite {
+    static constexpr addr_size MAX_LABEL_LEN = 512;
+
+    u64 key;
+    char label[MAX_LABEL_LEN]; // the allocation tag, or the captured stack frames
+    addr_size allocCount;
+    addr_size freeCount;
+    addr_size allocatedBytes; // over the lifetime of the tracer
+    addr_size inUseBytes;
+};
+
+enum struct AllocationSiteOrder : u8 {
+    IN_USE_BYTES,
+    ALLOCATED_BYTES,
+    ALLOC_COUNT,
+
+    SENTINEL
+};
+
+/**
+ * @brief Attributes live allocations to the place that requested them.
+ *
+ * A call site is identified by the calling thread's allocation tag, or, when no tag is set, by the last
+ * `stackFrameCount` stack frames. Capturing a stack trace symbolizes it, which costs several microseconds per
+ * allocation, so tags are the way to go for anything hot. A stackFrameCount of 0 puts everything that is not tagged
+ * under a single "<untagged>" site.
+ *
+ * The book-keeping comes straight from malloc, it never goes through the traced allocator.
+ *
+ * @note Thread-safe, except for clear.
+*/
+struct AllocationTracer {
+    // NOTE: This type exports functions instead of the whole struct for the same reason as the StdStatsAllocator.
+
+    static constexpr u32 DEFAULT_STACK_FRAME_COUNT = 8;
+
+    NO_COPY(AllocationTracer);
+    NO_MOVE(AllocationTracer);
+
+    CORE_API_EXPORT explicit AllocationTracer(u32 stackFrameCount = DEFAULT_STACK_FRAME_COUNT);
+
+    CORE_API_EXPORT void recordAlloc(void* ptr, addr_size byteLen);
+    CORE_API_EXPORT void recordFree(void* ptr);
+
+    CORE_API_EXPORT addr_size siteCount();
+
+    /**
+     * @brief Copies the `maxCount` biggest sites, sorted in descending order, into `out`. Returns how many were copied.
+    */
+    CORE_API_EXPORT addr_size topSites(AllocationSite* out, addr_size maxCount,
+                                       AllocationSiteOrder order = AllocationSiteOrder::IN_USE_BYTES);
+
+    /**
+     * @brief Writes the `maxCount` biggest sites through the logger.
+    */
+    CORE_API_EXPORT void logTopSites(addr_size maxCount, AllocationSiteOrder order = AllocationSiteOrder::IN_USE_BYTES);
+
+    CORE_API_EXPORT void clear(); // forgets all sites and releases the book-keeping memory
+
+private:
+    u32 findOrAddSite(u64 key, const char* label, addr_size labelLen);
+    bool growLiveTable();
+
+    u32 m_stackFrameCount;
+    core::AtomicBool m_lock;
+    AllocationSite* m_sites;
+    addr_size m_siteCount;
+    addr_size m_siteCap;
+    u32* m_siteSlots; // open addressing over m_sites, keyed by AllocationSite::key
+    addr_size m_siteSlotsCap;
+    TracedAllocation* m_live; // open addressing, keyed by the address of the allocation
+    addr_size m_liveCount;
+    addr_size m_liveCap;
+};
+
+/**
+ * @brief Decorator that records every request made to the wrapped allocator in an AllocationTracer.
+ *
+ * Useful for finding out which container is responsible for memory growth, or for a leak. Register it in place of the
+ * allocator under investigation and call `tracer().logTopSites(n)` at the point of interest.
+ *
+ * @note The wrapped allocator must outlive the decorator. Thread safety is that of the wrapped allocator.
+*/
+template <AllocatorConcept TAllocator>
+struct TracingAllocator {
+    NO_COPY(TracingAllocator);
+    NO_MOVE(TracingAllocator);
+
+    explicit TracingAllocator(TAllocator& allocator, u32 stackFrameCount = AllocationTracer::DEFAULT_STACK_FRAME_COUNT)
+        : m_allocator(&allocator)
+        , m_tracer(stackFrameCount) {}
+
+    const char* name() { return m_allocator->name(); }
+
+    void* alloc(addr_size count, addr_size size) {
+        void* ret = m_allocator->alloc(count, size);
+        if (ret) m_tracer.recordAlloc(ret, count * size);
+        return ret;
+    }
+
+    void* allocAligned(addr_size count, addr_size size, addr_size alignment) {
+        void* ret = m_allocator->allocAligned(count, size, alignment);
+        if (ret) m_tracer.recordAlloc(ret, count * size);
+        return ret;
+    }
+
+    void* calloc(addr_size count, addr_size size) {
+        void* ret = m_allocator->calloc(count, size);
+        if (ret) m_tracer.recordAlloc(ret, count * size);
+        return ret;
+    }
+
+    void* realloc(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize) {
+        void* ret = m_allocator->realloc(ptr, newCount, newSize, oldCount, oldSize);
+        if (ret) {
+            // The block now belongs to whoever resized it.
+            if (ptr) m_tracer.recordFree(ptr);
+            m_tracer.recordAlloc(ret, newCount * newSize);
+        }
+        return ret;
+    }
+
+    void free(void* ptr, addr_size count, addr_size size) {
+        if (ptr) m_tracer.recordFree(ptr);
+        m_allocator->free(ptr, count, size);
+    }
+
+    void freeAligned(void* ptr, addr_size count, addr_size size, addr_size alignment) {
+        if (ptr) m_tracer.recordFree(ptr);
+        m_allocator->freeAligned(ptr, count, size, alignment);
+    }
+
+    void clear() {
+        m_allocator->clear();
+        m_tracer.clear();
+    }
+
+    addr_size totalMemoryAllocated() { return m_allocator->totalMemoryAllocated(); }
+    addr_size inUseMemory() { return m_allocator->inUseMemory(); }
+
+    bool tracksMemory() { return m_allocator->tracksMemory(); }
+    bool canDetectLeaks() { return m_allocator->canDetectLeaks(); }
+
+    AllocationTracer& tracer() { return m_tracer; }
+    TAllocator& inner() { return *m_allocator; }
+
+private:
+    TAllocator* m_allocator;
+    AllocationTracer m_tracer;
+};
+static_assert(AllocatorConcept<TracingAllocator<StdAllocator>>);
 
 } // namespace core
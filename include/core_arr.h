@@ -26,6 +26,12 @@ inline void convArrList(To& to, From&& from) {
                 sizeof(to_value_type) % sizeof(from_value_type) == 0,
                 "The size of From's and To's value types must be compatible (i.e. divisible)");
 
+    // The data is released with the alignment of To's value type, which must match the one it was allocated with.
+    static_assert(alignof(from_value_type) == alignof(to_value_type) ||
+                  (alignof(from_value_type) <= core::MAX_FUNDAMENTAL_ALIGNMENT &&
+                   alignof(to_value_type) <= core::MAX_FUNDAMENTAL_ALIGNMENT),
+                "Over-aligned value types can only be converted to types with the same alignment");
+
     size_type len, cap;
     from_value_type* rawData = from.release(len, cap);
 
@@ -70,12 +76,12 @@ struct ArrList {
     ArrList() : m_data(nullptr), m_cap(0), m_len(0) {}
     ArrList(size_type cap) : m_data(nullptr), m_cap(cap), m_len(0) {
         if (m_cap > 0) {
-            m_data = reinterpret_cast<value_type *>(allocator.alloc(m_cap, sizeof(value_type)));
+            m_data = reinterpret_cast<value_type *>(allocator.allocAligned(m_cap, sizeof(value_type), alignof(value_type)));
         }
     }
     ArrList(size_type len, const T& v) : m_data(nullptr), m_cap(len), m_len(len) {
         if (m_cap > 0) {
-            m_data = reinterpret_cast<value_type *>(allocator.alloc(m_cap, sizeof(value_type)));
+            m_data = reinterpret_cast<value_type *>(allocator.allocAligned(m_cap, sizeof(value_type), alignof(value_type)));
             if constexpr (dataIsTrivial) {
                 core::memset(m_data, v, m_len);
             }
@@ -150,7 +156,7 @@ struct ArrList {
     ArrList copy() const {
         value_type* dataCopy = nullptr;
         if (m_cap > 0) {
-            dataCopy = reinterpret_cast<value_type *>(allocator.alloc(m_cap, sizeof(value_type)));
+            dataCopy = reinterpret_cast<value_type *>(allocator.allocAligned(m_cap, sizeof(value_type), alignof(value_type)));
             if constexpr (dataIsTrivial) {
                 core::memcopy(dataCopy, m_data, m_len);
             }
@@ -173,13 +179,14 @@ struct ArrList {
 
         clear();
 
-        allocator.free(m_data, m_cap, sizeof(value_type));
+        allocator.freeAligned(m_data, m_cap, sizeof(value_type), alignof(value_type));
         m_cap = 0;
         m_data = nullptr;
     }
 
     // This is the "I know what I am doing" method. Gives ownership of data to the array. The array's destructor will
-    // free it, so if a different allocator was used to allocate the data the results are undefined.
+    // free it, so if a different allocator was used to allocate the data the results are undefined. Over-aligned types
+    // must be allocated with allocAligned and alignof(T).
     void reset(value_type** data, size_type len, size_type cap) {
         free();
 
@@ -217,7 +224,14 @@ struct ArrList {
             return;
         }
 
-        value_type* newData = reinterpret_cast<value_type *>(allocator.alloc(newCap, sizeof(value_type)));
+        if constexpr (dataIsTrivial && alignof(value_type) <= core::DEFAULT_ALLOC_ALIGNMENT) {
+            // Trivial data can be moved by the allocator, which gives it the chance to grow the buffer in place.
+            m_data = reinterpret_cast<value_type *>(allocator.reallocate(m_data, newCap, sizeof(value_type), m_cap, sizeof(value_type)));
+            m_cap = newCap;
+            return;
+        }
+
+        value_type* newData = reinterpret_cast<value_type *>(allocator.allocAligned(newCap, sizeof(value_type), alignof(value_type)));
         if (m_data != nullptr) {
             if constexpr (dataIsTrivial) {
                 core::memcopy(newData, m_data, m_len);
@@ -234,7 +248,7 @@ struct ArrList {
                     m_data[i].~T();
                 }
             }
-            allocator.free(m_data, m_cap, sizeof(value_type));
+            allocator.freeAligned(m_data, m_cap, sizeof(value_type), alignof(value_type));
         }
 
         m_data = newData;
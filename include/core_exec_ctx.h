@@ -5,6 +5,8 @@
 #include <core_assert.h>
 #include <core_types.h>
 
+#include <plt/core_atomics.h>
+
 #include <new>
 
 namespace core {
@@ -20,29 +22,70 @@ AllocatorContext createAllocatorCtx(TAllocator* allocator);
 using AllocatorId = u32;
 constexpr AllocatorId DEFAULT_ALLOCATOR_ID = 0;
 
+/**
+ * @brief Snapshot of the statistics collected by an AllocatorContext. Sizes are the requested byte counts, before the
+ *        allocator rounds them up.
+*/
+struct AllocatorStats {
+    static constexpr addr_size SIZE_HISTOGRAM_BUCKET_COUNT = 64;
+
+    u64 allocCount;
+    u64 freeCount;
+    u64 reallocCount;
+    u64 reallocCopyCount; // reallocations which moved the data to a new address
+    u64 failedAllocCount;
+    u64 inUseBytes;
+    u64 peakInUseBytes;
+    u64 sizeHistogram[SIZE_HISTOGRAM_BUCKET_COUNT]; // bucket i counts requests in the range (2^(i-1), 2^i]
+};
+
+/**
+ * @brief The counters behind AllocatorStats. They are updated with relaxed atomics, which keeps them cheap enough to leave
+ *        on in production. A snapshot taken while other threads allocate is not consistent across fields.
+*/
+struct AllocatorStatsCounters {
+    core::AtomicU64 allocCount;
+    core::AtomicU64 freeCount;
+    core::AtomicU64 reallocCount;
+    core::AtomicU64 reallocCopyCount;
+    core::AtomicU64 failedAllocCount;
+    core::AtomicU64 inUseBytes;
+    core::AtomicU64 peakInUseBytes;
+    core::AtomicU64 sizeHistogram[AllocatorStats::SIZE_HISTOGRAM_BUCKET_COUNT];
+};
+
 using AllocateFn             = void *(*)(void* allocatorData, addr_size count, addr_size size);
+using AllocateAlignedFn      = void *(*)(void* allocatorData, addr_size count, addr_size size, addr_size alignment);
 using ZeroAllocateFn         = void *(*)(void* allocatorData, addr_size count, addr_size size);
 using ReAllocateFn           = void *(*)(void* allocatorData, void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize);
 using FreeFn                 = void (*)(void* allocatorData, void *ptr, addr_size count, addr_size size);
+using FreeAlignedFn          = void (*)(void* allocatorData, void *ptr, addr_size count, addr_size size, addr_size alignment);
 using ClearFn                = void (*)(void* allocatorData);
 using TotalMemoryAllocatedFn = addr_size (*)(void* allocatorData);
 using InUseMemoryFn          = addr_size (*)(void* allocatorData);
 using AllocatorNameFn        = const char* (*)(void* allocatorData);
 using TracksMemoryFn         = bool (*)(void* allocatorData);
 using CanDetectLeaksFn       = bool (*)(void* allocatorData);
+using SaveCheckpointFn       = AllocatorCheckpoint (*)(void* allocatorData);
+using RestoreCheckpointFn    = void (*)(void* allocatorData, const AllocatorCheckpoint& checkpoint);
 
 struct CORE_API_EXPORT AllocatorContext {
     AllocateFn allocFn;
+    AllocateAlignedFn allocAlignedFn;
     ZeroAllocateFn callocFn;
     ReAllocateFn reallocFn;
     FreeFn freeFn;
+    FreeAlignedFn freeAlignedFn;
     ClearFn clearFn;
     TotalMemoryAllocatedFn totalMemoryAllocatedFn;
     InUseMemoryFn inUseMemoryFn;
     AllocatorNameFn nameFn;
     TracksMemoryFn tracksMemoryFn;
     CanDetectLeaksFn canDetectLeaksFn;
+    SaveCheckpointFn saveCheckpointFn; // null when the allocator does not support checkpoints
+    RestoreCheckpointFn restoreCheckpointFn; // null when the allocator does not support checkpoints
     void* allocatorData;
+    AllocatorStatsCounters* statsCounters; // null when statistics are not collected
 
     AllocatorContext(void* allocatorData = nullptr);
     AllocatorContext(const AllocatorContext& other) = default;
@@ -55,9 +98,11 @@ struct CORE_API_EXPORT AllocatorContext {
     const char* name();
 
     void* alloc(addr_size count, addr_size size);
+    void* allocAligned(addr_size count, addr_size size, addr_size alignment);
     void* zeroAlloc(addr_size count, addr_size size);
     void* reallocate(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize);
     void free(void* ptr, addr_size count, addr_size size);
+    void freeAligned(void* ptr, addr_size count, addr_size size, addr_size alignment);
     void clear();
     addr_size totalMemoryAllocated();
     addr_size inUseMemory();
@@ -65,6 +110,14 @@ struct CORE_API_EXPORT AllocatorContext {
     bool tracksMemory();
     bool canDetectLeaks();
 
+    bool supportsCheckpoints();
+    AllocatorCheckpoint saveCheckpoint();
+    void restoreCheckpoint(const AllocatorCheckpoint& checkpoint);
+
+    bool hasStats();
+    AllocatorStats stats();
+    void resetStats(); // keeps the bytes which are still in use
+
     template <typename T, typename... Args>
     T* construct(Args&&... args) {
         T* ptr = reinterpret_cast<T*>(alloc(1, sizeof(T)));
@@ -85,6 +138,10 @@ AllocatorContext createAllocatorCtx(TAllocator* allocator) {
         auto& a = *reinterpret_cast<TAllocator*>(allocatorData);
         return a.alloc(count, size);
     };
+    ctx.allocAlignedFn = [](void* allocatorData, core::addr_size count, core::addr_size size, core::addr_size alignment) -> void* {
+        auto& a = *reinterpret_cast<TAllocator*>(allocatorData);
+        return a.allocAligned(count, size, alignment);
+    };
     ctx.callocFn = [](void* allocatorData, core::addr_size count, core::addr_size size) -> void* {
         auto& a = *reinterpret_cast<TAllocator*>(allocatorData);
         return a.calloc(count, size);
@@ -97,6 +154,10 @@ AllocatorContext createAllocatorCtx(TAllocator* allocator) {
         auto& a = *reinterpret_cast<TAllocator*>(allocatorData);
         a.free(ptr, count, size);
     };
+    ctx.freeAlignedFn = [](void* allocatorData, void* ptr, core::addr_size count, core::addr_size size, core::addr_size alignment) {
+        auto& a = *reinterpret_cast<TAllocator*>(allocatorData);
+        a.freeAligned(ptr, count, size, alignment);
+    };
     ctx.clearFn = [](void* allocatorData) {
         auto& a = *reinterpret_cast<TAllocator*>(allocatorData);
         a.clear();
@@ -117,10 +178,39 @@ AllocatorContext createAllocatorCtx(TAllocator* allocator) {
         auto& a = *reinterpret_cast<TAllocator*>(allocatorData);
         return a.canDetectLeaks();
     };
+    if constexpr (CheckpointAllocatorConcept<TAllocator>) {
+        ctx.saveCheckpointFn = [](void* allocatorData) -> AllocatorCheckpoint {
+            auto& a = *reinterpret_cast<TAllocator*>(allocatorData);
+            return a.saveCheckpoint();
+        };
+        ctx.restoreCheckpointFn = [](void* allocatorData, const AllocatorCheckpoint& checkpoint) {
+            auto& a = *reinterpret_cast<TAllocator*>(allocatorData);
+            a.restoreCheckpoint(checkpoint);
+        };
+    }
 
     return ctx;
 }
 
+/**
+ * @brief Saves a checkpoint of the allocator on construction and restores it on destruction, which releases all scratch
+ *        memory allocated inside the scope while leaving the caller's allocations alone.
+ *
+ * @note Does nothing when the allocator does not support checkpoints.
+*/
+struct CORE_API_EXPORT AllocatorCheckpointScope {
+    NO_COPY(AllocatorCheckpointScope);
+    NO_MOVE(AllocatorCheckpointScope);
+
+    explicit AllocatorCheckpointScope(AllocatorContext& actx);
+    explicit AllocatorCheckpointScope(AllocatorId id);
+    ~AllocatorCheckpointScope();
+
+private:
+    AllocatorContext* m_actx;
+    AllocatorCheckpoint m_checkpoint;
+};
+
 CORE_API_EXPORT void initProgramCtx(GlobalAssertHandlerFn assertHandler,
                                     LoggerCreateInfo* loggerCreateInfo);
 CORE_API_EXPORT void initProgramCtx(GlobalAssertHandlerFn assertHandler,
@@ -129,6 +219,10 @@ CORE_API_EXPORT void initProgramCtx(GlobalAssertHandlerFn assertHandler,
 
 CORE_API_EXPORT void destroyProgramCtx(bool panicOnLeaks = true);
 
+/**
+ * @brief Registers an allocator under the given id. Registered allocators, and the default one, always collect
+ *        statistics.
+*/
 CORE_API_EXPORT void registerAllocator(AllocatorContext&& ctx, AllocatorId id);
 CORE_API_EXPORT AllocatorContext& getAllocator(AllocatorId id);
 
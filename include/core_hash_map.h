@@ -67,8 +67,8 @@ struct HashMap {
         m_cap = cap > 0 ? detail::nextPowerOf2ForCap(cap) : 0;
         m_len = 0;
         if (m_cap > 0) {
-            m_keys        = reinterpret_cast<key_type*>(allocator.alloc(m_cap, sizeof(key_type)));
-            m_values      = reinterpret_cast<value_type*>(allocator.alloc(m_cap, sizeof(value_type)));
+            m_keys        = reinterpret_cast<key_type*>(allocator.allocAligned(m_cap, sizeof(key_type), alignof(key_type)));
+            m_values      = reinterpret_cast<value_type*>(allocator.allocAligned(m_cap, sizeof(value_type), alignof(value_type)));
             m_bucketState = reinterpret_cast<BucketState*>(allocator.zeroAlloc(m_cap, sizeof(BucketState)));
         }
         else {
@@ -141,8 +141,8 @@ struct HashMap {
 
         clear();
 
-        allocator.free(m_keys, m_cap, sizeof(key_type));
-        allocator.free(m_values, m_cap, sizeof(value_type));
+        allocator.freeAligned(m_keys, m_cap, sizeof(key_type), alignof(key_type));
+        allocator.freeAligned(m_values, m_cap, sizeof(value_type), alignof(value_type));
         allocator.free(m_bucketState, m_cap, sizeof(BucketState));
 
         m_cap = 0;
@@ -157,8 +157,8 @@ struct HashMap {
         BucketState* copyBucketState = nullptr;
 
         if (m_cap > 0) {
-            copyData        = reinterpret_cast<value_type *>(allocator.alloc(m_cap, sizeof(value_type)));
-            copyKeys        = reinterpret_cast<key_type *>(allocator.alloc(m_cap, sizeof(key_type)));
+            copyData        = reinterpret_cast<value_type *>(allocator.allocAligned(m_cap, sizeof(value_type), alignof(value_type)));
+            copyKeys        = reinterpret_cast<key_type *>(allocator.allocAligned(m_cap, sizeof(key_type), alignof(key_type)));
             copyBucketState = reinterpret_cast<BucketState *>(allocator.alloc(m_cap, sizeof(BucketState)));
 
             for (size_type i = 0; i < m_cap; i++) {
@@ -227,8 +227,8 @@ struct HashMap {
 
         newCap = detail::nextPowerOf2ForCap(newCap);
 
-        key_type* newKeys           = reinterpret_cast<key_type*>(allocator.alloc(newCap, sizeof(key_type)));
-        value_type* newValues       = reinterpret_cast<value_type*>(allocator.alloc(newCap, sizeof(value_type)));
+        key_type* newKeys           = reinterpret_cast<key_type*>(allocator.allocAligned(newCap, sizeof(key_type), alignof(key_type)));
+        value_type* newValues       = reinterpret_cast<value_type*>(allocator.allocAligned(newCap, sizeof(value_type), alignof(value_type)));
         BucketState* newBucketState = reinterpret_cast<BucketState*>(allocator.zeroAlloc(newCap, sizeof(BucketState)));
 
         for (size_type i = 0; i < m_cap; i++) {
@@ -249,8 +249,8 @@ struct HashMap {
         }
 
         if (m_keys) {
-            allocator.free(m_keys, m_cap, sizeof(key_type));
-            allocator.free(m_values, m_cap, sizeof(value_type));
+            allocator.freeAligned(m_keys, m_cap, sizeof(key_type), alignof(key_type));
+            allocator.freeAligned(m_values, m_cap, sizeof(value_type), alignof(value_type));
             allocator.free(m_bucketState, m_cap, sizeof(BucketState));
         }
 
@@ -443,7 +443,7 @@ constexpr addr_size align(addr_size n) {
 constexpr addr_size align(addr_size n, u32 alignment) {
     Assert(alignment > 0, "Alignment must be non-zero");
     Assert(core::ispow2(alignment), "Alignment must be a power of 2");
-    return (n + alignment - 1) & ~(alignment - 1);
+    return (n + alignment - 1) & ~(addr_size(alignment) - 1);
 }
 
 template <typename T>
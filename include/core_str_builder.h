@@ -197,12 +197,14 @@ struct CORE_API_EXPORT StrBuilder {
             return;
         }
 
-        value_type* newData = reinterpret_cast<value_type *>(allocator.zeroAlloc(newCap, sizeof(value_type)));
-        if (m_data != nullptr) {
-            core::memcopy(newData, m_data, m_len);
-            allocator.free(m_data, m_cap, sizeof(value_type));
+        if (m_data == nullptr) {
+            m_data = reinterpret_cast<value_type *>(allocator.zeroAlloc(newCap, sizeof(value_type)));
+        }
+        else {
+            // Reallocating gives the allocator the chance to grow the buffer in place.
+            m_data = reinterpret_cast<value_type *>(allocator.reallocate(m_data, newCap, sizeof(value_type), m_cap, sizeof(value_type)));
+            core::memset(m_data + m_len, value_type(0), newCap - m_len);
         }
-        m_data = newData;
         m_cap = newCap;
     }
 
@@ -712,7 +712,7 @@ constexpr u64 pow2(u32 i) {
 }
 
 constexpr bool ispow2(u32 x) {
-    return (x & (x - 1)) != 0;
+    return x != 0 && (x & (x - 1)) == 0;
 }
 
 #pragma endregion
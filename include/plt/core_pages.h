@@ -13,4 +13,16 @@ CORE_API_EXPORT expected<void*, PltErrCode> allocPages(addr_size count);
 CORE_API_EXPORT expected<PltErrCode> freePages(void* addr, addr_size count);
 CORE_API_EXPORT addr_size getPageSize();
 
+/**
+ * @brief Reserves a range of address space without backing it with memory. Touching the range is invalid until pages are
+ *        committed with commitPages. The whole range is released with freePages.
+*/
+CORE_API_EXPORT expected<void*, PltErrCode> reservePages(addr_size count);
+CORE_API_EXPORT expected<PltErrCode> commitPages(void* addr, addr_size count);
+
+/**
+ * @brief Returns the memory behind committed pages to the OS, but keeps the address range reserved.
+*/
+CORE_API_EXPORT expected<PltErrCode> decommitPages(void* addr, addr_size count);
+
 } // namespace core
@@ -19,19 +19,24 @@ inline void _setBuffer(void** startAddr, void** currentAddr, addr_size* capacity
     *capacity = cap;
 }
 
+inline addr_size _alignPadding(const void* addr, addr_size alignment) {
+    return (addr_size(0) - reinterpret_cast<addr_size>(addr)) & (alignment - 1);
+}
+
 inline void* _alloc(void** currentAddr, const void* startAddr, addr_size cap, const OOMHandlerFn oomHandler,
-                    addr_size count, addr_size size) {
+                    addr_size count, addr_size size, addr_size alignment = 1) {
     addr_size effectiveSize = count * size;
     effectiveSize = core::align(effectiveSize);
-    if (addr_size(core::ptrDiff(*currentAddr, startAddr)) + effectiveSize > cap) {
+    addr_size padding = _alignPadding(*currentAddr, alignment);
+    if (addr_size(core::ptrDiff(*currentAddr, startAddr)) + padding + effectiveSize > cap) {
         if (oomHandler) {
             oomHandler();
         }
         return nullptr;
     }
 
-    void* ret = *currentAddr;
-    *currentAddr = core::ptrAdvance(*currentAddr, effectiveSize);
+    void* ret = core::ptrAdvance(*currentAddr, padding);
+    *currentAddr = core::ptrAdvance(ret, effectiveSize);
     return ret;
 }
 
@@ -46,11 +51,33 @@ inline void* _calloc(void** currentAddr, const void* startAddr, addr_size cap, c
     return ret;
 }
 
+inline bool _isLastAllocation(void* const* currentAddr, const void* data, addr_size byteLen) {
+    return data != nullptr && core::ptrDiff(*currentAddr, data) == addr_off(core::align(byteLen));
+}
+
+inline void _free(void** currentAddr, const void* data, addr_size count, addr_size size) {
+    // Only the most recent allocation can be given back.
+    if (_isLastAllocation(currentAddr, data, count * size)) {
+        *currentAddr = const_cast<void*>(data);
+    }
+}
+
 inline void* _recalloc(void** currentAddr, const void* startAddr, addr_size cap, const OOMHandlerFn oomHandler,
                        const void* data, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize) {
-    void* ret = _alloc(currentAddr, startAddr, cap, oomHandler, newCount, newSize);
     addr_size newByteLen = newCount * newSize;
     addr_size oldByteLen = oldCount * oldSize;
+
+    if (_isLastAllocation(currentAddr, data, oldByteLen)) {
+        // The allocation is at the end of the buffer, so it can grow, or shrink, in place.
+        addr_size offset = addr_size(core::ptrDiff(data, startAddr));
+        if (offset + core::align(newByteLen) <= cap) {
+            void* ret = const_cast<void*>(data);
+            *currentAddr = core::ptrAdvance(ret, core::align(newByteLen));
+            return ret;
+        }
+    }
+
+    void* ret = _alloc(currentAddr, startAddr, cap, oomHandler, newCount, newSize);
     addr_size copyLen = core::core_min(newByteLen, oldByteLen);
     if (ret && copyLen > 0) {
         core::memcopy(reinterpret_cast<u8*>(ret), reinterpret_cast<const u8*>(data), copyLen);
@@ -58,6 +85,18 @@ inline void* _recalloc(void** currentAddr, const void* startAddr, addr_size cap,
     return ret;
 }
 
+inline AllocatorCheckpoint _saveCheckpoint(const void* currentAddr, const void* startAddr) {
+    AllocatorCheckpoint ret = {};
+    ret.data[0] = addr_size(core::ptrDiff(currentAddr, startAddr));
+    return ret;
+}
+
+inline void _restoreCheckpoint(void** currentAddr, void* startAddr, const AllocatorCheckpoint& checkpoint) {
+    Assert(checkpoint.data[0] <= addr_size(core::ptrDiff(*currentAddr, startAddr)),
+           "Checkpoints must be restored in reverse order");
+    *currentAddr = core::ptrAdvance(startAddr, checkpoint.data[0]);
+}
+
 } // namespace
 
 // Bump Allocator
@@ -94,6 +133,11 @@ void* BumpAllocator::alloc(addr_size count, addr_size size) {
     return _alloc(&m_currentAddr, m_startAddr, m_cap, oomHandler, count, size);
 }
 
+void* BumpAllocator::allocAligned(addr_size count, addr_size size, addr_size alignment) {
+    Assert(core::ispow2(u32(alignment)), "Alignment must be a power of 2");
+    return _alloc(&m_currentAddr, m_startAddr, m_cap, oomHandler, count, size, alignment);
+}
+
 void* BumpAllocator::calloc(addr_size count, addr_size size) {
     return _calloc(&m_currentAddr, m_startAddr, m_cap, oomHandler, count, size);
 }
@@ -102,7 +146,13 @@ void* BumpAllocator::realloc(void* ptr, addr_size newCount, addr_size newSize, a
     return _recalloc(&m_currentAddr, m_startAddr, m_cap, oomHandler, ptr, newCount, newSize, oldCount, oldSize);
 }
 
-void BumpAllocator::free(void*, addr_size, addr_size) {}
+void BumpAllocator::free(void* ptr, addr_size count, addr_size size) {
+    _free(&m_currentAddr, ptr, count, size);
+}
+
+void BumpAllocator::freeAligned(void* ptr, addr_size count, addr_size size, addr_size) {
+    _free(&m_currentAddr, ptr, count, size);
+}
 
 void BumpAllocator::clear() {
     m_currentAddr = m_startAddr;
@@ -117,6 +167,14 @@ addr_size BumpAllocator::inUseMemory() {
     return ret;
 }
 
+AllocatorCheckpoint BumpAllocator::saveCheckpoint() {
+    return _saveCheckpoint(m_currentAddr, m_startAddr);
+}
+
+void BumpAllocator::restoreCheckpoint(const AllocatorCheckpoint& checkpoint) {
+    _restoreCheckpoint(&m_currentAddr, m_startAddr, checkpoint);
+}
+
 // Thread Local Bump Allocator
 
 ThreadLocalBumpAllocator::ThreadLocalBumpAllocator() : oomHandler(getDefaultOOMHandler()) {}
@@ -136,6 +194,11 @@ void* ThreadLocalBumpAllocator::alloc(addr_size count, addr_size size) {
     return _alloc(&tl_currentAddr, tl_startAddr, tl_capacity, oomHandler, count, size);
 }
 
+void* ThreadLocalBumpAllocator::allocAligned(addr_size count, addr_size size, addr_size alignment) {
+    Assert(core::ispow2(u32(alignment)), "Alignment must be a power of 2");
+    return _alloc(&tl_currentAddr, tl_startAddr, tl_capacity, oomHandler, count, size, alignment);
+}
+
 void* ThreadLocalBumpAllocator::calloc(addr_size count, addr_size size) {
     return _calloc(&tl_currentAddr, tl_startAddr, tl_capacity, oomHandler, count, size);
 }
@@ -144,7 +207,13 @@ void* ThreadLocalBumpAllocator::realloc(void* ptr, addr_size newCount, addr_size
     return _recalloc(&tl_currentAddr, tl_startAddr, tl_capacity, oomHandler, ptr, newCount, newSize, oldCount, oldSize);
 }
 
-void ThreadLocalBumpAllocator::free(void*, addr_size, addr_size) {}
+void ThreadLocalBumpAllocator::free(void* ptr, addr_size count, addr_size size) {
+    _free(&tl_currentAddr, ptr, count, size);
+}
+
+void ThreadLocalBumpAllocator::freeAligned(void* ptr, addr_size count, addr_size size, addr_size) {
+    _free(&tl_currentAddr, ptr, count, size);
+}
 
 void ThreadLocalBumpAllocator::clear() {
     tl_currentAddr = tl_startAddr;
@@ -159,4 +228,12 @@ addr_size ThreadLocalBumpAllocator::inUseMemory() {
     return ret;
 }
 
+AllocatorCheckpoint ThreadLocalBumpAllocator::saveCheckpoint() {
+    return _saveCheckpoint(tl_currentAddr, tl_startAddr);
+}
+
+void ThreadLocalBumpAllocator::restoreCheckpoint(const AllocatorCheckpoint& checkpoint) {
+    _restoreCheckpoint(&tl_currentAddr, tl_startAddr, checkpoint);
+}
+
 } // namespace core
@@ -0,0 +1,303 @@
+#include <core_alloc.h>
+#include <core_assert.h>
+#include <core_intrinsics.h>
+#include <core_mem.h>
+
+#include <math/core_math.h>
+
+#include <plt/core_pages.h>
+
+namespace core {
+
+struct PoolSlab {
+    PoolSlab* next;
+    addr_size pageCount;
+};
+
+struct PoolLargeBlock {
+    PoolLargeBlock* prev;
+    PoolLargeBlock* next;
+    addr_size pageCount;
+};
+
+namespace {
+
+// Headers are padded to a cache line so that the blocks which follow keep the natural alignment of their size class.
+constexpr addr_size POOL_HEADER_SIZE = 64;
+static_assert(sizeof(PoolSlab) <= POOL_HEADER_SIZE);
+static_assert(sizeof(PoolLargeBlock) <= POOL_HEADER_SIZE);
+
+constexpr u32 MIN_BLOCK_SIZE_LOG2 = 4;
+static_assert(PoolAllocator::MIN_BLOCK_SIZE == (1 << MIN_BLOCK_SIZE_LOG2));
+static_assert(PoolAllocator::MAX_BLOCK_SIZE == (PoolAllocator::MIN_BLOCK_SIZE << (PoolAllocator::SIZE_CLASS_COUNT - 1)));
+
+inline addr_size sizeClassIdx(addr_size size) {
+    if (size <= PoolAllocator::MIN_BLOCK_SIZE) {
+        return 0;
+    }
+    // ceil(log2(size)) - log2(MIN_BLOCK_SIZE)
+    u32 log2Ceil = u32(sizeof(u64) * 8) - core::intrin_countLeadingZeros(u64(size - 1));
+    return addr_size(log2Ceil - MIN_BLOCK_SIZE_LOG2);
+}
+
+constexpr inline addr_size sizeClassBlockSize(addr_size classIdx) {
+    return PoolAllocator::MIN_BLOCK_SIZE << classIdx;
+}
+
+// Large blocks keep their header at the start of the first page. The data follows at `dataOffset`, which is the header
+// size, or the requested alignment when that is stricter.
+inline addr_size pagesForLargeBlock(addr_size size, addr_size dataOffset, addr_size pageSize) {
+    return (size + dataOffset + pageSize - 1) / pageSize;
+}
+
+} // namespace
+
+PoolAllocator::PoolAllocator() : PoolAllocator(DEFAULT_SLAB_PAGE_COUNT) {}
+
+PoolAllocator::PoolAllocator(addr_size slabPageCount)
+    : oomHandler(getDefaultOOMHandler())
+    , m_freeLists{}
+    , m_carveCurr{}
+    , m_carveEnd{}
+    , m_slabs(nullptr)
+    , m_largeBlocks(nullptr)
+    , m_slabPageCount(slabPageCount)
+    , m_pageSize(core::getPageSize())
+    , m_totalMemoryAllocated(0)
+    , m_inUseMemory(0) {
+    Panic(m_slabPageCount * m_pageSize >= POOL_HEADER_SIZE + MAX_BLOCK_SIZE, "Slab can't fit a single block of every size class");
+}
+
+PoolAllocator::PoolAllocator(PoolAllocator&& other) {
+    oomHandler = other.oomHandler;
+    for (addr_size i = 0; i < SIZE_CLASS_COUNT; i++) {
+        m_freeLists[i] = other.m_freeLists[i];
+        m_carveCurr[i] = other.m_carveCurr[i];
+        m_carveEnd[i] = other.m_carveEnd[i];
+        other.m_freeLists[i] = nullptr;
+        other.m_carveCurr[i] = nullptr;
+        other.m_carveEnd[i] = nullptr;
+    }
+    m_slabs = other.m_slabs;
+    m_largeBlocks = other.m_largeBlocks;
+    m_slabPageCount = other.m_slabPageCount;
+    m_pageSize = other.m_pageSize;
+    m_totalMemoryAllocated = other.m_totalMemoryAllocated;
+    m_inUseMemory = other.m_inUseMemory;
+
+    other.oomHandler = nullptr;
+    other.m_slabs = nullptr;
+    other.m_largeBlocks = nullptr;
+    other.m_totalMemoryAllocated = 0;
+    other.m_inUseMemory = 0;
+}
+
+void PoolAllocator::setSlabPageCount(addr_size slabPageCount) {
+    clear();
+    Panic(slabPageCount * m_pageSize >= POOL_HEADER_SIZE + MAX_BLOCK_SIZE, "Slab can't fit a single block of every size class");
+    m_slabPageCount = slabPageCount;
+}
+
+void* PoolAllocator::allocLarge(addr_size size, addr_size dataOffset) {
+    addr_size pageCount = pagesForLargeBlock(size, dataOffset, m_pageSize);
+    auto res = core::allocPages(pageCount);
+    if (res.hasErr()) {
+        if (oomHandler) {
+            oomHandler();
+        }
+        return nullptr;
+    }
+
+    PoolLargeBlock* block = reinterpret_cast<PoolLargeBlock*>(res.value());
+    block->prev = nullptr;
+    block->next = m_largeBlocks;
+    block->pageCount = pageCount;
+    if (m_largeBlocks) {
+        m_largeBlocks->prev = block;
+    }
+    m_largeBlocks = block;
+
+    m_totalMemoryAllocated += pageCount * m_pageSize;
+    m_inUseMemory += size;
+    return core::ptrAdvance(block, dataOffset);
+}
+
+void PoolAllocator::freeLarge(void* ptr, addr_size size, addr_size dataOffset) {
+    PoolLargeBlock* block = reinterpret_cast<PoolLargeBlock*>(reinterpret_cast<u8*>(ptr) - dataOffset);
+    if (block->prev) block->prev->next = block->next;
+    else m_largeBlocks = block->next;
+    if (block->next) block->next->prev = block->prev;
+
+    addr_size pageCount = block->pageCount;
+    Assert(pageCount == pagesForLargeBlock(size, dataOffset, m_pageSize), "Freeing with a different size than allocated");
+    m_totalMemoryAllocated -= pageCount * m_pageSize;
+    m_inUseMemory -= size;
+    core::freePages(block, pageCount);
+}
+
+void* PoolAllocator::alloc(addr_size count, addr_size size) {
+    Assert(count > 0 && size > 0, "Invalid Arguments");
+
+    addr_size effectiveSize = count * size;
+
+    if (effectiveSize > MAX_BLOCK_SIZE) {
+        return allocLarge(effectiveSize, POOL_HEADER_SIZE);
+    }
+
+    addr_size classIdx = sizeClassIdx(effectiveSize);
+    addr_size blockSize = sizeClassBlockSize(classIdx);
+
+    // Fast path: reuse a freed block.
+    if (void* head = m_freeLists[classIdx]; head != nullptr) {
+        m_freeLists[classIdx] = *reinterpret_cast<void**>(head);
+        m_inUseMemory += blockSize;
+        return head;
+    }
+
+    // Carve a new block out of the slab which is assigned to this size class.
+    if (m_carveCurr[classIdx] == m_carveEnd[classIdx]) {
+        auto res = core::allocPages(m_slabPageCount);
+        if (res.hasErr()) {
+            if (oomHandler) {
+                oomHandler();
+            }
+            return nullptr;
+        }
+
+        addr_size slabSize = m_slabPageCount * m_pageSize;
+        PoolSlab* slab = reinterpret_cast<PoolSlab*>(res.value());
+        slab->next = m_slabs;
+        slab->pageCount = m_slabPageCount;
+        m_slabs = slab;
+        m_totalMemoryAllocated += slabSize;
+
+        addr_size usable = ((slabSize - POOL_HEADER_SIZE) / blockSize) * blockSize;
+        m_carveCurr[classIdx] = core::ptrAdvance(slab, POOL_HEADER_SIZE);
+        m_carveEnd[classIdx] = core::ptrAdvance(m_carveCurr[classIdx], usable);
+    }
+
+    void* ret = m_carveCurr[classIdx];
+    m_carveCurr[classIdx] = core::ptrAdvance(ret, blockSize);
+    m_inUseMemory += blockSize;
+    return ret;
+}
+
+void* PoolAllocator::allocAligned(addr_size count, addr_size size, addr_size alignment) {
+    Assert(count > 0 && size > 0, "Invalid Arguments");
+    Assert(core::ispow2(u32(alignment)), "Alignment must be a power of 2");
+    Assert(alignment <= m_pageSize, "Alignment can't be larger than the page size");
+
+    if (alignment <= POOL_HEADER_SIZE) {
+        // Rounding the size up to the alignment selects a size class which is aligned well enough.
+        return alloc(core::core_max(count * size, alignment), 1);
+    }
+
+    return allocLarge(count * size, alignment);
+}
+
+void* PoolAllocator::calloc(addr_size count, addr_size size) {
+    void* ret = alloc(count, size);
+    if (ret) {
+        core::memset(reinterpret_cast<u8*>(ret), u8(0), count * size);
+    }
+    return ret;
+}
+
+void* PoolAllocator::realloc(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize) {
+    Assert(newCount > 0 && newSize > 0, "Invalid Argument");
+
+    addr_size newByteLen = newCount * newSize;
+    addr_size oldByteLen = oldCount * oldSize;
+
+    if (ptr == nullptr || oldByteLen == 0) {
+        return alloc(newCount, newSize);
+    }
+
+    if (newByteLen <= MAX_BLOCK_SIZE && oldByteLen <= MAX_BLOCK_SIZE &&
+        sizeClassIdx(newByteLen) == sizeClassIdx(oldByteLen)) {
+        // Still fits in the same block.
+        return ptr;
+    }
+
+    if (newByteLen > MAX_BLOCK_SIZE && oldByteLen > MAX_BLOCK_SIZE &&
+        pagesForLargeBlock(newByteLen, POOL_HEADER_SIZE, m_pageSize) == pagesForLargeBlock(oldByteLen, POOL_HEADER_SIZE, m_pageSize)) {
+        // Still fits in the same pages.
+        m_inUseMemory = m_inUseMemory - oldByteLen + newByteLen;
+        return ptr;
+    }
+
+    void* ret = alloc(newCount, newSize);
+    if (ret == nullptr) {
+        return nullptr;
+    }
+
+    addr_size copyLen = core::core_min(newByteLen, oldByteLen);
+    core::memcopy(reinterpret_cast<u8*>(ret), reinterpret_cast<const u8*>(ptr), copyLen);
+    free(ptr, oldCount, oldSize);
+    return ret;
+}
+
+void PoolAllocator::free(void* ptr, addr_size count, addr_size size) {
+    if (ptr == nullptr) {
+        return;
+    }
+
+    addr_size effectiveSize = count * size;
+    Assert(effectiveSize > 0, "Invalid Argument");
+
+    if (effectiveSize > MAX_BLOCK_SIZE) {
+        freeLarge(ptr, effectiveSize, POOL_HEADER_SIZE);
+        return;
+    }
+
+    addr_size classIdx = sizeClassIdx(effectiveSize);
+    *reinterpret_cast<void**>(ptr) = m_freeLists[classIdx];
+    m_freeLists[classIdx] = ptr;
+    m_inUseMemory -= sizeClassBlockSize(classIdx);
+}
+
+void PoolAllocator::freeAligned(void* ptr, addr_size count, addr_size size, addr_size alignment) {
+    if (ptr == nullptr) {
+        return;
+    }
+
+    if (alignment <= POOL_HEADER_SIZE) {
+        free(ptr, core::core_max(count * size, alignment), 1);
+        return;
+    }
+
+    freeLarge(ptr, count * size, alignment);
+}
+
+void PoolAllocator::clear() {
+    while (m_slabs) {
+        PoolSlab* next = m_slabs->next;
+        core::freePages(m_slabs, m_slabs->pageCount);
+        m_slabs = next;
+    }
+
+    while (m_largeBlocks) {
+        PoolLargeBlock* next = m_largeBlocks->next;
+        core::freePages(m_largeBlocks, m_largeBlocks->pageCount);
+        m_largeBlocks = next;
+    }
+
+    for (addr_size i = 0; i < SIZE_CLASS_COUNT; i++) {
+        m_freeLists[i] = nullptr;
+        m_carveCurr[i] = nullptr;
+        m_carveEnd[i] = nullptr;
+    }
+
+    m_totalMemoryAllocated = 0;
+    m_inUseMemory = 0;
+}
+
+addr_size PoolAllocator::totalMemoryAllocated() {
+    return m_totalMemoryAllocated;
+}
+
+addr_size PoolAllocator::inUseMemory() {
+    return m_inUseMemory;
+}
+
+} // namespace core
@@ -1,10 +1,35 @@
 #include <core_alloc.h>
 #include <core_assert.h>
+#include <core_mem.h>
 
 #include <cstdlib>
 
 namespace core {
 
+namespace {
+
+// malloc only guarantees MAX_FUNDAMENTAL_ALIGNMENT. Stricter requests over-allocate and keep the pointer returned by
+// malloc right before the aligned block, so it can be found again on free.
+inline void* _overAlignedMalloc(addr_size byteLen, addr_size alignment) {
+    void* raw = std::malloc(byteLen + alignment);
+    if (raw == nullptr) {
+        return nullptr;
+    }
+
+    addr_size addr = core::align(reinterpret_cast<addr_size>(raw) + sizeof(void*), u32(alignment));
+    void** ret = reinterpret_cast<void**>(addr);
+    ret[-1] = raw;
+    return ret;
+}
+
+inline void _overAlignedFree(void* ptr) {
+    if (ptr) {
+        std::free(reinterpret_cast<void**>(ptr)[-1]);
+    }
+}
+
+} // namespace
+
 StdAllocator::StdAllocator() : oomHandler(getDefaultOOMHandler()) {}
 
 void* StdAllocator::alloc(addr_size count, addr_size size) {
@@ -18,6 +43,22 @@ void* StdAllocator::alloc(addr_size count, addr_size size) {
     return ret;
 }
 
+void* StdAllocator::allocAligned(addr_size count, addr_size size, addr_size alignment) {
+    Assert(count > 0 && size > 0, "Invalid Arguments");
+    Assert(core::ispow2(u32(alignment)), "Alignment must be a power of 2");
+
+    if (alignment <= MAX_FUNDAMENTAL_ALIGNMENT) {
+        return alloc(count, size);
+    }
+
+    void* ret = _overAlignedMalloc(count * size, alignment);
+    if (ret == nullptr && oomHandler) {
+        oomHandler();
+        return nullptr;
+    }
+    return ret;
+}
+
 void* StdAllocator::calloc(addr_size count, addr_size size) {
     Assert(count > 0 && size > 0, "Invalid Arguments");
 
@@ -33,6 +74,14 @@ void StdAllocator::free(void* ptr, addr_size, addr_size) {
     std::free(ptr);
 }
 
+void StdAllocator::freeAligned(void* ptr, addr_size, addr_size, addr_size alignment) {
+    if (alignment <= MAX_FUNDAMENTAL_ALIGNMENT) {
+        std::free(ptr);
+        return;
+    }
+    _overAlignedFree(ptr);
+}
+
 void* StdAllocator::realloc(void* ptr, addr_size newCount, addr_size newSize, addr_size, addr_size) {
     Assert(newCount > 0 && newSize > 0, "Invalid Argument");
 
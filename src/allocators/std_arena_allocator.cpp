@@ -14,70 +14,186 @@ struct ArenaBlock {
     void* curr;
 };
 
+struct ArenaOversizedBlock {
+    ArenaOversizedBlock* next;
+    addr_size size;
+};
+
 namespace {
 
-thread_local ArenaBlock* tl_blocks = nullptr;
-thread_local addr_size tl_blockCount = 0;
-thread_local addr_size tl_blockSize = 0;
+using detail::ArenaState;
 
-inline void* _alloc(ArenaBlock** blocksPtr, addr_size* blockCountPtr, const addr_size blockSize,
-                    const OOMHandlerFn oomHandler,
-                    addr_size size, addr_size count) {
+constexpr addr_size ARENA_INITIAL_BLOCK_TABLE_CAP = 8;
+constexpr addr_size ARENA_OVERSIZED_HEADER_SIZE = 16; // keeps oversized allocations 16 byte aligned
+static_assert(sizeof(ArenaOversizedBlock) <= ARENA_OVERSIZED_HEADER_SIZE);
 
-    auto& blocks = *blocksPtr;
-    auto& blockCount = *blockCountPtr;
+thread_local ArenaState tl_state = {};
 
-    addr_size effectiveSize = count * size;
-    Panic(effectiveSize > 0, "Invalid allocation size");
+inline addr_size _blockFreeSpace(const ArenaBlock& block, addr_size blockSize) {
+    return blockSize - addr_size(core::ptrDiff(block.curr, block.begin));
+}
 
-    effectiveSize = core::align(effectiveSize);
-    Panic(effectiveSize <= blockSize, "Allocation size exceeds block size");
-
-    for (addr_size i = 0; i < blockCount; ++i) {
-        void* blockEnd = core::ptrAdvance(blocks[i].begin, blockSize);
-        addr_size freeSpace = addr_size(core::ptrDiff(blockEnd, blocks[i].curr));
-        if (freeSpace >= effectiveSize) {
-            // Found a block with enough space
-            void* ret = blocks[i].curr;
-            blocks[i].curr = core::ptrAdvance(blocks[i].curr, effectiveSize);
-            return ret;
-        }
+inline addr_size _alignPadding(const void* addr, addr_size alignment) {
+    return (addr_size(0) - reinterpret_cast<addr_size>(addr)) & (alignment - 1);
+}
+
+inline void* _bumpBlock(ArenaBlock& block, addr_size padding, addr_size effectiveSize) {
+    void* ret = core::ptrAdvance(block.curr, padding);
+    block.curr = core::ptrAdvance(ret, effectiveSize);
+    return ret;
+}
+
+inline void _rememberPartialBlock(ArenaState& s, addr_size blockIdx) {
+    addr_size freeSpace = _blockFreeSpace(s.blocks[blockIdx], s.blockSize);
+    if (freeSpace == 0) {
+        return;
     }
 
-    // No block with enough space. Allocate a new block.
+    if (s.partialCount < ArenaState::PARTIAL_BLOCKS_MAX) {
+        s.partialBlocks[s.partialCount++] = blockIdx;
+        return;
+    }
 
-    void* newBlockMemory = std::malloc(blockSize);
-    if (newBlockMemory == nullptr) {
-        if (oomHandler) {
-            oomHandler();
+    // The list is full. Replace the block with the least free space, if the new one has more.
+    addr_size minIdx = 0;
+    addr_size minFreeSpace = _blockFreeSpace(s.blocks[s.partialBlocks[0]], s.blockSize);
+    for (addr_size i = 1; i < s.partialCount; ++i) {
+        addr_size curr = _blockFreeSpace(s.blocks[s.partialBlocks[i]], s.blockSize);
+        if (curr < minFreeSpace) {
+            minFreeSpace = curr;
+            minIdx = i;
         }
-        return nullptr;
+    }
+    if (freeSpace > minFreeSpace) {
+        s.partialBlocks[minIdx] = blockIdx;
+    }
+}
+
+inline bool _ensureBlockTableCap(ArenaState& s) {
+    if (s.blockCount < s.blockCap) {
+        return true;
     }
 
-    void* newBlocks = static_cast<ArenaBlock*>(std::realloc(blocks, (blockCount + 1) * sizeof(ArenaBlock)));
+    addr_size newCap = s.blockCap == 0 ? ARENA_INITIAL_BLOCK_TABLE_CAP : s.blockCap * 2;
+    void* newBlocks = std::realloc(s.blocks, newCap * sizeof(ArenaBlock));
     if (newBlocks == nullptr) {
-        std::free(newBlockMemory); // give up on the new block
+        return false;
+    }
+
+    s.blocks = static_cast<ArenaBlock*>(newBlocks);
+    s.blockCap = newCap;
+    return true;
+}
+
+inline void* _allocOversized(ArenaState& s, const OOMHandlerFn oomHandler, addr_size effectiveSize, addr_size alignment) {
+    addr_size maxPadding = alignment > ARENA_OVERSIZED_HEADER_SIZE ? alignment - ARENA_OVERSIZED_HEADER_SIZE : 0;
+    void* mem = std::malloc(ARENA_OVERSIZED_HEADER_SIZE + maxPadding + effectiveSize);
+    if (mem == nullptr) {
         if (oomHandler) {
             oomHandler();
         }
         return nullptr;
     }
 
-    blocks = static_cast<ArenaBlock*>(newBlocks);
-    ArenaBlock& block = blocks[blockCount];
-    block.begin = newBlockMemory;
-    block.curr = block.begin;
-    blockCount++;
+    ArenaOversizedBlock* block = reinterpret_cast<ArenaOversizedBlock*>(mem);
+    block->next = s.oversizedBlocks;
+    block->size = effectiveSize;
+    s.oversizedBlocks = block;
+    s.oversizedBytes += effectiveSize;
 
-    void* ret = block.curr;
-    block.curr = core::ptrAdvance(block.curr, effectiveSize);
-    return ret;
+    void* data = core::ptrAdvance(mem, ARENA_OVERSIZED_HEADER_SIZE);
+    return core::ptrAdvance(data, _alignPadding(data, alignment));
+}
+
+inline void _freeOversizedBlocks(ArenaState& s) {
+    ArenaOversizedBlock* curr = s.oversizedBlocks;
+    while (curr) {
+        ArenaOversizedBlock* next = curr->next;
+        std::free(curr);
+        curr = next;
+    }
+    s.oversizedBlocks = nullptr;
+    s.oversizedBytes = 0;
+}
+
+inline void* _alloc(ArenaState& s, const OOMHandlerFn oomHandler, addr_size size, addr_size count,
+                    addr_size alignment = 1) {
+    addr_size effectiveSize = count * size;
+    Panic(effectiveSize > 0, "Invalid allocation size");
+
+    effectiveSize = core::align(effectiveSize);
+
+    // Blocks come from malloc, so only alignments stricter than what it guarantees need padding in a fresh block.
+    addr_size maxPadding = alignment > MAX_FUNDAMENTAL_ALIGNMENT ? alignment - MAX_FUNDAMENTAL_ALIGNMENT : 0;
+    if (effectiveSize + maxPadding > s.blockSize) {
+        return _allocOversized(s, oomHandler, effectiveSize, alignment);
+    }
+
+    // Fill the holes left behind in previous blocks first.
+    for (addr_size i = 0; i < s.partialCount; ++i) {
+        ArenaBlock& block = s.blocks[s.partialBlocks[i]];
+        addr_size freeSpace = _blockFreeSpace(block, s.blockSize);
+        addr_size padding = _alignPadding(block.curr, alignment);
+        if (freeSpace >= padding + effectiveSize) {
+            void* ret = _bumpBlock(block, padding, effectiveSize);
+            if (freeSpace == padding + effectiveSize) {
+                s.partialBlocks[i] = s.partialBlocks[s.partialCount - 1];
+                s.partialCount--;
+            }
+            return ret;
+        }
+    }
+
+    if (s.currBlockIdx < s.blockCount) {
+        ArenaBlock& block = s.blocks[s.currBlockIdx];
+        addr_size padding = _alignPadding(block.curr, alignment);
+        if (_blockFreeSpace(block, s.blockSize) >= padding + effectiveSize) {
+            return _bumpBlock(block, padding, effectiveSize);
+        }
+    }
+
+    // The current block is full. Move the cursor to the next block, which might already be owned by the arena after a
+    // reset, or allocate a new one.
+
+    addr_size nextIdx = s.blockCount == 0 ? 0 : s.currBlockIdx + 1;
+
+    if (nextIdx < s.blockCount) {
+        s.blocks[nextIdx].curr = s.blocks[nextIdx].begin; // blocks after the cursor are reset lazily
+    }
+    else {
+        void* newBlockMemory = std::malloc(s.blockSize);
+        if (newBlockMemory == nullptr) {
+            if (oomHandler) {
+                oomHandler();
+            }
+            return nullptr;
+        }
+
+        if (!_ensureBlockTableCap(s)) {
+            std::free(newBlockMemory); // give up on the new block
+            if (oomHandler) {
+                oomHandler();
+            }
+            return nullptr;
+        }
+
+        ArenaBlock& block = s.blocks[s.blockCount];
+        block.begin = newBlockMemory;
+        block.curr = block.begin;
+        s.blockCount++;
+    }
+
+    if (s.currBlockIdx < s.blockCount && nextIdx != s.currBlockIdx) {
+        _rememberPartialBlock(s, s.currBlockIdx);
+    }
+    s.currBlockIdx = nextIdx;
+
+    ArenaBlock& block = s.blocks[nextIdx];
+    return _bumpBlock(block, _alignPadding(block.curr, alignment), effectiveSize);
 }
 
-inline void* _calloc(ArenaBlock** blocks, addr_size* blockCount, const addr_size blockSize,
-                     const OOMHandlerFn oomHandler,
-                     addr_size size, addr_size count) {
-    void* ret = _alloc(blocks, blockCount, blockSize, oomHandler, size, count);
+inline void* _calloc(ArenaState& s, const OOMHandlerFn oomHandler, addr_size size, addr_size count) {
+    void* ret = _alloc(s, oomHandler, size, count);
     if (ret) {
         addr_size effectiveSize = size * count;
         effectiveSize = core::align(effectiveSize);
@@ -86,45 +202,160 @@ inline void* _calloc(ArenaBlock** blocks, addr_size* blockCount, const addr_size
     return ret;
 }
 
-inline void* _realloc(ArenaBlock** blocks, addr_size* blockCount, const addr_size blockSize,
-                     const OOMHandlerFn oomHandler,
-                     const void* data, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize) {
-    void* ret = _alloc(blocks, blockCount, blockSize, oomHandler, newSize, newCount);
+// Returns the block in which `data` is the most recent allocation. Only the current block and the partially filled ones
+// are searched, which keeps this O(1).
+inline ArenaBlock* _findTailBlock(ArenaState& s, const void* data, addr_size byteLen) {
+    if (data == nullptr || s.blockCount == 0) {
+        return nullptr;
+    }
+
+    auto isTail = [&](const ArenaBlock& block) {
+        return core::ptrDiff(data, block.begin) >= 0 &&
+               core::ptrDiff(block.curr, data) == addr_off(core::align(byteLen));
+    };
+
+    if (isTail(s.blocks[s.currBlockIdx])) {
+        return &s.blocks[s.currBlockIdx];
+    }
+    for (addr_size i = 0; i < s.partialCount; ++i) {
+        if (isTail(s.blocks[s.partialBlocks[i]])) {
+            return &s.blocks[s.partialBlocks[i]];
+        }
+    }
+    return nullptr;
+}
+
+inline void _free(ArenaState& s, void* data, addr_size count, addr_size size) {
+    // Only the most recent allocation in a block can be given back.
+    if (ArenaBlock* block = _findTailBlock(s, data, count * size); block != nullptr) {
+        block->curr = data;
+    }
+}
+
+inline void* _realloc(ArenaState& s, const OOMHandlerFn oomHandler,
+                      void* data, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize) {
     addr_size newByteLen = newCount * newSize;
     addr_size oldByteLen = oldCount * oldSize;
+
+    ArenaBlock* tailBlock = _findTailBlock(s, data, oldByteLen);
+    if (tailBlock != nullptr) {
+        // The allocation is at the end of its block, so it can grow, or shrink, in place.
+        addr_size offset = addr_size(core::ptrDiff(data, tailBlock->begin));
+        if (offset + core::align(newByteLen) <= s.blockSize) {
+            tailBlock->curr = core::ptrAdvance(data, core::align(newByteLen));
+            return data;
+        }
+    }
+
+    bool wasTail = tailBlock != nullptr;
+    addr_size tailBlockIdx = wasTail ? addr_size(tailBlock - s.blocks) : 0;
+
+    void* ret = _alloc(s, oomHandler, newSize, newCount); // NOTE: might move the block table
     addr_size copyLen = core::core_min(newByteLen, oldByteLen);
     if (ret && copyLen > 0) {
         core::memcopy(reinterpret_cast<u8*>(ret), reinterpret_cast<const u8*>(data), copyLen);
     }
+    if (ret && wasTail) {
+        s.blocks[tailBlockIdx].curr = data; // the old allocation can be reused
+    }
     return ret;
 }
 
-inline void _clear(ArenaBlock* blocks, addr_size blockCount) {
-    if (blocks == nullptr || blockCount == 0) {
-        return;
+inline void _clear(ArenaState& s) {
+    for (addr_size i = 0; i < s.blockCount; ++i) {
+        std::free(s.blocks[i].begin);
     }
+    std::free(s.blocks);
+    _freeOversizedBlocks(s);
+
+    s.blocks = nullptr;
+    s.blockCount = 0;
+    s.blockCap = 0;
+    s.currBlockIdx = 0;
+    s.partialCount = 0;
+}
+
+constexpr inline addr_size _totalMemoryAllocated(const ArenaState& s) {
+    return s.blockCount * s.blockSize + s.oversizedBytes;
+}
 
-    for (addr_size i = 0; i < blockCount; ++i) {
-        std::free(blocks[i].begin);
+inline addr_size _inUseMemory(const ArenaState& s) {
+    addr_size ret = s.oversizedBytes;
+    if (s.blockCount == 0) {
+        return ret;
     }
-    std::free(blocks);
+
+    // Blocks after the cursor are reset lazily, so they hold no live allocations.
+    for (addr_size i = 0; i <= s.currBlockIdx; ++i) {
+        ret += addr_size(core::ptrDiff(s.blocks[i].curr, s.blocks[i].begin));
+    }
+    return ret;
 }
 
-constexpr inline addr_size _totalMemoryAllocated(addr_size blockCount, addr_size blockSize) {
-    return blockCount * blockSize;
+inline void _reset(ArenaState& s) {
+    _freeOversizedBlocks(s);
+    s.currBlockIdx = 0;
+    s.partialCount = 0;
+    if (s.blockCount > 0) {
+        s.blocks[0].curr = s.blocks[0].begin;
+    }
 }
 
-inline addr_size _inUseMemory(ArenaBlock* blocks, addr_size blockCount) {
-    addr_size ret = 0;
-    for (addr_size i = 0; i < blockCount; ++i) {
-        ret += addr_size(core::ptrDiff(blocks[i].curr, blocks[i].begin));
+// Checkpoint layout: the cursor block and its fill level, the partially filled blocks and their fill levels, and the head
+// of the oversized list. Blocks after the cursor are reset lazily, so nothing else needs to be saved.
+constexpr addr_size CHECKPOINT_CURR_BLOCK_IDX = 0;
+constexpr addr_size CHECKPOINT_CURR_BLOCK_OFFSET = 1;
+constexpr addr_size CHECKPOINT_PARTIAL_COUNT = 2;
+constexpr addr_size CHECKPOINT_PARTIAL_BLOCKS = 3;
+constexpr addr_size CHECKPOINT_PARTIAL_OFFSETS = CHECKPOINT_PARTIAL_BLOCKS + ArenaState::PARTIAL_BLOCKS_MAX;
+constexpr addr_size CHECKPOINT_OVERSIZED_HEAD = CHECKPOINT_PARTIAL_OFFSETS + ArenaState::PARTIAL_BLOCKS_MAX;
+static_assert(CHECKPOINT_OVERSIZED_HEAD < AllocatorCheckpoint::DATA_SIZE);
+
+inline AllocatorCheckpoint _saveCheckpoint(const ArenaState& s) {
+    AllocatorCheckpoint ret = {};
+    ret.data[CHECKPOINT_OVERSIZED_HEAD] = reinterpret_cast<addr_size>(s.oversizedBlocks);
+    if (s.blockCount == 0) {
+        return ret;
+    }
+
+    const ArenaBlock& currBlock = s.blocks[s.currBlockIdx];
+    ret.data[CHECKPOINT_CURR_BLOCK_IDX] = s.currBlockIdx;
+    ret.data[CHECKPOINT_CURR_BLOCK_OFFSET] = addr_size(core::ptrDiff(currBlock.curr, currBlock.begin));
+    ret.data[CHECKPOINT_PARTIAL_COUNT] = s.partialCount;
+    for (addr_size i = 0; i < s.partialCount; ++i) {
+        const ArenaBlock& block = s.blocks[s.partialBlocks[i]];
+        ret.data[CHECKPOINT_PARTIAL_BLOCKS + i] = s.partialBlocks[i];
+        ret.data[CHECKPOINT_PARTIAL_OFFSETS + i] = addr_size(core::ptrDiff(block.curr, block.begin));
     }
     return ret;
 }
 
-inline void _reset(ArenaBlock* blocks, addr_size blockCount) {
-    for (addr_size i = 0; i < blockCount; ++i) {
-        blocks[i].curr = blocks[i].begin;
+inline void _restoreCheckpoint(ArenaState& s, const AllocatorCheckpoint& checkpoint) {
+    // Oversized allocations are pushed to the front of the list, so the ones made after the checkpoint come first.
+    auto savedOversizedHead = reinterpret_cast<ArenaOversizedBlock*>(checkpoint.data[CHECKPOINT_OVERSIZED_HEAD]);
+    while (s.oversizedBlocks != savedOversizedHead) {
+        Assert(s.oversizedBlocks != nullptr, "Checkpoints must be restored in reverse order");
+        ArenaOversizedBlock* next = s.oversizedBlocks->next;
+        s.oversizedBytes -= s.oversizedBlocks->size;
+        std::free(s.oversizedBlocks);
+        s.oversizedBlocks = next;
+    }
+
+    if (s.blockCount == 0) {
+        return;
+    }
+
+    addr_size currBlockIdx = checkpoint.data[CHECKPOINT_CURR_BLOCK_IDX];
+    Assert(currBlockIdx <= s.currBlockIdx, "Checkpoints must be restored in reverse order");
+    s.currBlockIdx = currBlockIdx;
+    s.blocks[currBlockIdx].curr = core::ptrAdvance(s.blocks[currBlockIdx].begin,
+                                                   checkpoint.data[CHECKPOINT_CURR_BLOCK_OFFSET]);
+
+    s.partialCount = checkpoint.data[CHECKPOINT_PARTIAL_COUNT];
+    for (addr_size i = 0; i < s.partialCount; ++i) {
+        addr_size blockIdx = checkpoint.data[CHECKPOINT_PARTIAL_BLOCKS + i];
+        s.partialBlocks[i] = blockIdx;
+        s.blocks[blockIdx].curr = core::ptrAdvance(s.blocks[blockIdx].begin, checkpoint.data[CHECKPOINT_PARTIAL_OFFSETS + i]);
     }
 }
 
@@ -134,57 +365,70 @@ inline void _reset(ArenaBlock* blocks, addr_size blockCount) {
 
 StdArenaAllocator::StdArenaAllocator(addr_size blockSize)
     : oomHandler(getDefaultOOMHandler())
-    , m_blocks(nullptr)
-    , m_blockCount(0)
-    , m_blockSize(blockSize) {}
+    , m_state({}) {
+    m_state.blockSize = blockSize;
+}
 
 StdArenaAllocator::StdArenaAllocator(StdArenaAllocator&& other) {
-    m_blocks = other.m_blocks;
-    m_blockCount = other.m_blockCount;
-    m_blockSize = other.m_blockSize;
+    m_state = other.m_state;
     oomHandler = other.oomHandler;
 
-    other.m_blocks = nullptr;
-    other.m_blockCount = 0;
-    other.m_blockSize = 0;
+    other.m_state = {};
     other.oomHandler = nullptr;
 }
 
 void StdArenaAllocator::setBlockSize(addr_size blockSize) {
     clear();
-    m_blockSize = blockSize;
+    m_state.blockSize = blockSize;
 }
 
 void* StdArenaAllocator::alloc(addr_size count, addr_size size) {
-    return _alloc(&m_blocks, &m_blockCount, m_blockSize, oomHandler, size, count);
+    return _alloc(m_state, oomHandler, size, count);
+}
+
+void* StdArenaAllocator::allocAligned(addr_size count, addr_size size, addr_size alignment) {
+    Assert(core::ispow2(u32(alignment)), "Alignment must be a power of 2");
+    return _alloc(m_state, oomHandler, size, count, alignment);
 }
 
 void* StdArenaAllocator::calloc(addr_size count, addr_size size) {
-    return _calloc(&m_blocks, &m_blockCount, m_blockSize, oomHandler, size, count);
+    return _calloc(m_state, oomHandler, size, count);
 }
 
 void* StdArenaAllocator::realloc(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize) {
-    return _realloc(&m_blocks, &m_blockCount, m_blockSize, oomHandler, ptr, newCount, newSize, oldCount, oldSize);
+    return _realloc(m_state, oomHandler, ptr, newCount, newSize, oldCount, oldSize);
 }
 
-void StdArenaAllocator::free(void*, addr_size, addr_size) {}
+void StdArenaAllocator::free(void* ptr, addr_size count, addr_size size) {
+    _free(m_state, ptr, count, size);
+}
+
+void StdArenaAllocator::freeAligned(void* ptr, addr_size count, addr_size size, addr_size) {
+    _free(m_state, ptr, count, size);
+}
 
 void StdArenaAllocator::clear() {
-    _clear(m_blocks, m_blockCount);
-    m_blocks = nullptr;
-    m_blockCount = 0;
+    _clear(m_state);
 }
 
 addr_size StdArenaAllocator::totalMemoryAllocated() {
-    return _totalMemoryAllocated(m_blockCount, m_blockSize);
+    return _totalMemoryAllocated(m_state);
 }
 
 addr_size StdArenaAllocator::inUseMemory() {
-    return _inUseMemory(m_blocks, m_blockCount);
+    return _inUseMemory(m_state);
 }
 
 void StdArenaAllocator::reset() {
-    _reset(m_blocks, m_blockCount);
+    _reset(m_state);
+}
+
+AllocatorCheckpoint StdArenaAllocator::saveCheckpoint() {
+    return _saveCheckpoint(m_state);
+}
+
+void StdArenaAllocator::restoreCheckpoint(const AllocatorCheckpoint& checkpoint) {
+    _restoreCheckpoint(m_state, checkpoint);
 }
 
 // Thread Local Std Arena Allocator
@@ -192,49 +436,65 @@ void StdArenaAllocator::reset() {
 ThreadLocalStdArenaAllocator::ThreadLocalStdArenaAllocator() : oomHandler(getDefaultOOMHandler()) {}
 
 ThreadLocalStdArenaAllocator ThreadLocalStdArenaAllocator::create(addr_size blockSize) {
-    Panic(tl_blockSize == 0, "ThreadLocalStdArenaAllocator::create() called twice in the same thread");
+    Panic(tl_state.blockSize == 0, "ThreadLocalStdArenaAllocator::create() called twice in the same thread");
     Panic(blockSize > 0, "ThreadLocalStdArenaAllocator::create() Invalid block size");
-    tl_blockSize = blockSize;
-    tl_blockCount = 0;
-    tl_blocks = nullptr;
+    tl_state = {};
+    tl_state.blockSize = blockSize;
     return ThreadLocalStdArenaAllocator{};
 }
 
 void ThreadLocalStdArenaAllocator::setBlockSize(addr_size blockSize) {
     clear();
-    tl_blockSize = blockSize;
+    tl_state.blockSize = blockSize;
 }
 
 void* ThreadLocalStdArenaAllocator::alloc(addr_size count, addr_size size) {
-    return _alloc(&tl_blocks, &tl_blockCount, tl_blockSize, oomHandler, size, count);
+    return _alloc(tl_state, oomHandler, size, count);
+}
+
+void* ThreadLocalStdArenaAllocator::allocAligned(addr_size count, addr_size size, addr_size alignment) {
+    Assert(core::ispow2(u32(alignment)), "Alignment must be a power of 2");
+    return _alloc(tl_state, oomHandler, size, count, alignment);
 }
 
 void* ThreadLocalStdArenaAllocator::calloc(addr_size count, addr_size size) {
-    return _calloc(&tl_blocks, &tl_blockCount, tl_blockSize, oomHandler, size, count);
+    return _calloc(tl_state, oomHandler, size, count);
 }
 
 void* ThreadLocalStdArenaAllocator::realloc(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize) {
-    return _realloc(&tl_blocks, &tl_blockCount, tl_blockSize, oomHandler, ptr, newCount, newSize, oldCount, oldSize);
+    return _realloc(tl_state, oomHandler, ptr, newCount, newSize, oldCount, oldSize);
 }
 
-void ThreadLocalStdArenaAllocator::free(void*, addr_size, addr_size) {}
+void ThreadLocalStdArenaAllocator::free(void* ptr, addr_size count, addr_size size) {
+    _free(tl_state, ptr, count, size);
+}
+
+void ThreadLocalStdArenaAllocator::freeAligned(void* ptr, addr_size count, addr_size size, addr_size) {
+    _free(tl_state, ptr, count, size);
+}
 
 void ThreadLocalStdArenaAllocator::clear() {
-    _clear(tl_blocks, tl_blockCount);
-    tl_blocks = nullptr;
-    tl_blockCount = 0;
+    _clear(tl_state);
 }
 
 addr_size ThreadLocalStdArenaAllocator::totalMemoryAllocated() {
-    return _totalMemoryAllocated(tl_blockCount, tl_blockSize);
+    return _totalMemoryAllocated(tl_state);
 }
 
 addr_size ThreadLocalStdArenaAllocator::inUseMemory() {
-    return _inUseMemory(tl_blocks, tl_blockCount);
+    return _inUseMemory(tl_state);
 }
 
 void ThreadLocalStdArenaAllocator::reset() {
-    _reset(tl_blocks, tl_blockCount);
+    _reset(tl_state);
+}
+
+AllocatorCheckpoint ThreadLocalStdArenaAllocator::saveCheckpoint() {
+    return _saveCheckpoint(tl_state);
+}
+
+void ThreadLocalStdArenaAllocator::restoreCheckpoint(const AllocatorCheckpoint& checkpoint) {
+    _restoreCheckpoint(tl_state, checkpoint);
 }
 
 } // namespace core
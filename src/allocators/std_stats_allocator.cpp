@@ -6,6 +6,29 @@
 
 namespace core {
 
+namespace {
+
+// Same scheme as the StdAllocator. The pointer returned by malloc is kept right before the aligned block.
+inline void* _overAlignedMalloc(addr_size byteLen, addr_size alignment) {
+    void* raw = std::malloc(byteLen + alignment);
+    if (raw == nullptr) {
+        return nullptr;
+    }
+
+    addr_size addr = core::align(reinterpret_cast<addr_size>(raw) + sizeof(void*), u32(alignment));
+    void** ret = reinterpret_cast<void**>(addr);
+    ret[-1] = raw;
+    return ret;
+}
+
+inline void _overAlignedFree(void* ptr) {
+    if (ptr) {
+        std::free(reinterpret_cast<void**>(ptr)[-1]);
+    }
+}
+
+} // namespace
+
 StdStatsAllocator::StdStatsAllocator() : oomHandler(getDefaultOOMHandler()), m_totalMemoryAllocated(0), m_inUseMemory(0) {}
 
 StdStatsAllocator::StdStatsAllocator(StdStatsAllocator&& other) {
@@ -32,6 +55,27 @@ void* StdStatsAllocator::alloc(addr_size count, addr_size size) {
     return ret;
 }
 
+void* StdStatsAllocator::allocAligned(addr_size count, addr_size size, addr_size alignment) {
+    Assert(count > 0 && size > 0, "Invalid Argument");
+    Assert(core::ispow2(u32(alignment)), "Alignment must be a power of 2");
+
+    if (alignment <= MAX_FUNDAMENTAL_ALIGNMENT) {
+        return alloc(count, size);
+    }
+
+    addr_size effectiveSize = count * size;
+    void* ret = _overAlignedMalloc(effectiveSize, alignment);
+    if (ret == nullptr && oomHandler) {
+        oomHandler();
+        return nullptr;
+    }
+
+    effectiveSize = core::align(effectiveSize);
+    m_totalMemoryAllocated.fetch_add(effectiveSize);
+    m_inUseMemory.fetch_add(effectiveSize);
+    return ret;
+}
+
 void* StdStatsAllocator::calloc(addr_size count, addr_size size) {
     Assert(count > 0 && size > 0, "Invalid Argument");
 
@@ -86,6 +130,19 @@ void StdStatsAllocator::free(void* ptr, addr_size count, addr_size size) {
     std::free(ptr);
 }
 
+void StdStatsAllocator::freeAligned(void* ptr, addr_size count, addr_size size, addr_size alignment) {
+    if (alignment <= MAX_FUNDAMENTAL_ALIGNMENT) {
+        free(ptr, count, size);
+        return;
+    }
+
+    Assert(count > 0 && size > 0, "Invalid Argument");
+
+    addr_size effectiveSize = core::align(count * size);
+    m_inUseMemory.fetch_sub(effectiveSize);
+    _overAlignedFree(ptr);
+}
+
 void StdStatsAllocator::clear() {
     m_totalMemoryAllocated.store(0);
     m_inUseMemory.store(0);
@@ -0,0 +1,499 @@
+#include <core_alloc.h>
+#include <core_assert.h>
+#include <core_intrinsics.h>
+#include <core_mem.h>
+
+#include <math/core_math.h>
+
+#include <plt/core_pages.h>
+
+#include <new>
+
+namespace core {
+
+using TCA = ThreadCachingAllocator;
+
+struct ThreadCache {
+    // Only touched by the thread which owns the cache.
+    void* freeLists[TCA::SIZE_CLASS_COUNT];
+    void* carveCurr[TCA::SIZE_CLASS_COUNT];
+    void* carveEnd[TCA::SIZE_CLASS_COUNT];
+    core::AtomicI64 inUseMemory; // written only by the owner, may go negative when it frees blocks of other threads
+    core::AtomicBool active;
+    ThreadCache* next; // never changes once the cache is published
+
+    // Blocks freed by other threads. Kept on a separate cache line, because this is the only shared state.
+    alignas(64) core::AtomicPtr remoteFrees[TCA::SIZE_CLASS_COUNT];
+};
+
+struct ThreadCacheSlab {
+    ThreadCache* owner;
+    addr_size classIdx;
+};
+
+struct ThreadCacheLargeBlock {
+    ThreadCacheLargeBlock* prev;
+    ThreadCacheLargeBlock* next;
+    addr_size pageCount;
+};
+
+namespace {
+
+constexpr u32 STATE_UNINITIALIZED = 0;
+constexpr u32 STATE_INITIALIZING = 1;
+constexpr u32 STATE_READY = 2;
+
+// Padded to a cache line so that large allocations keep the same alignment as in the PoolAllocator.
+constexpr addr_size LARGE_HEADER_SIZE = 64;
+static_assert(sizeof(ThreadCacheLargeBlock) <= LARGE_HEADER_SIZE);
+
+constexpr u32 MIN_BLOCK_SIZE_LOG2 = 4;
+static_assert(TCA::MIN_BLOCK_SIZE == (1 << MIN_BLOCK_SIZE_LOG2));
+static_assert(TCA::MAX_BLOCK_SIZE == (TCA::MIN_BLOCK_SIZE << (TCA::SIZE_CLASS_COUNT - 1)));
+static_assert(TCA::SLAB_SIZE % TCA::MAX_BLOCK_SIZE == 0);
+
+inline addr_size sizeClassIdx(addr_size size) {
+    if (size <= TCA::MIN_BLOCK_SIZE) {
+        return 0;
+    }
+    // ceil(log2(size)) - log2(MIN_BLOCK_SIZE)
+    u32 log2Ceil = u32(sizeof(u64) * 8) - core::intrin_countLeadingZeros(u64(size - 1));
+    return addr_size(log2Ceil - MIN_BLOCK_SIZE_LOG2);
+}
+
+constexpr inline addr_size sizeClassBlockSize(addr_size classIdx) {
+    return TCA::MIN_BLOCK_SIZE << classIdx;
+}
+
+inline addr_size pagesForLargeBlock(addr_size size, addr_size dataOffset, addr_size pageSize) {
+    return (size + dataOffset + pageSize - 1) / pageSize;
+}
+
+inline addr_size pagesFor(addr_size size, addr_size pageSize) {
+    return (size + pageSize - 1) / pageSize;
+}
+
+inline void addInUseMemory(ThreadCache& cache, i64 delta) {
+    // Single writer, a read-modify-write is not needed.
+    cache.inUseMemory.store(cache.inUseMemory.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+// Every allocator which holds memory owns a slot, the epoch tells apart allocators which used the same slot over time.
+core::AtomicU64 g_liveEpochs[TCA::MAX_LIVE_INSTANCES];
+core::AtomicU64 g_nextEpoch { 1 };
+
+struct ThreadCacheSlots {
+    ThreadCache* caches[TCA::MAX_LIVE_INSTANCES] = {};
+    u64 epochs[TCA::MAX_LIVE_INSTANCES] = {};
+
+    ~ThreadCacheSlots() {
+        // The thread is exiting. Hand its caches over to whichever thread needs one next, unless the allocator has been
+        // cleared in the meantime.
+        for (addr_size i = 0; i < TCA::MAX_LIVE_INSTANCES; i++) {
+            if (caches[i] != nullptr && g_liveEpochs[i].load(std::memory_order_acquire) == epochs[i]) {
+                caches[i]->active.store(false, std::memory_order_release);
+            }
+        }
+    }
+};
+
+thread_local ThreadCacheSlots tl_slots;
+
+} // namespace
+
+ThreadCachingAllocator::ThreadCachingAllocator() : ThreadCachingAllocator(DEFAULT_RESERVE_SIZE) {}
+
+ThreadCachingAllocator::ThreadCachingAllocator(addr_size reserveSize)
+    : oomHandler(getDefaultOOMHandler())
+    , m_state(STATE_UNINITIALIZED)
+    , m_slot(0)
+    , m_epoch(0)
+    , m_reserveSize(0)
+    , m_pageSize(core::getPageSize())
+    , m_slabCount(0)
+    , m_slabsBase(nullptr)
+    , m_slabs(nullptr)
+    , m_nextSlab(0)
+    , m_caches(nullptr)
+    , m_largeBlocksLock(false)
+    , m_largeBlocks(nullptr)
+    , m_largeInUseMemory(0)
+    , m_totalMemoryAllocated(0) {
+    Panic(SLAB_SIZE % m_pageSize == 0, "The slab size must be a multiple of the page size");
+    m_reserveSize = core::align(reserveSize, u32(SLAB_SIZE));
+}
+
+void ThreadCachingAllocator::setReserveSize(addr_size reserveSize) {
+    clear();
+    m_reserveSize = core::align(reserveSize, u32(SLAB_SIZE));
+}
+
+bool ThreadCachingAllocator::ensureInitialized() {
+    if (m_state.load(std::memory_order_acquire) == STATE_READY) {
+        return true;
+    }
+
+    u32 expected = STATE_UNINITIALIZED;
+    if (!m_state.compare_exchange_strong(expected, STATE_INITIALIZING, std::memory_order_acquire)) {
+        // Another thread got here first, wait for it to finish.
+        while ((expected = m_state.load(std::memory_order_acquire)) == STATE_INITIALIZING) {}
+        return expected == STATE_READY;
+    }
+
+    bool ok = initialize();
+    m_state.store(ok ? STATE_READY : STATE_UNINITIALIZED, std::memory_order_release);
+    return ok;
+}
+
+bool ThreadCachingAllocator::initialize() {
+    u64 epoch = g_nextEpoch.fetch_add(1, std::memory_order_relaxed);
+    u32 slot = u32(MAX_LIVE_INSTANCES);
+    for (u32 i = 0; i < u32(MAX_LIVE_INSTANCES); i++) {
+        u64 expected = 0;
+        if (g_liveEpochs[i].compare_exchange_strong(expected, epoch)) {
+            slot = i;
+            break;
+        }
+    }
+    Panic(slot < u32(MAX_LIVE_INSTANCES), "Too many live ThreadCachingAllocator instances");
+
+    auto reserved = core::reservePages(m_reserveSize / m_pageSize);
+    if (reserved.hasErr()) {
+        g_liveEpochs[slot].store(0);
+        return false;
+    }
+
+    addr_size slabCount = m_reserveSize / SLAB_SIZE;
+    auto slabs = core::allocPages(pagesFor(slabCount * sizeof(ThreadCacheSlab), m_pageSize));
+    if (slabs.hasErr()) {
+        core::freePages(reserved.value(), m_reserveSize / m_pageSize);
+        g_liveEpochs[slot].store(0);
+        return false;
+    }
+
+    m_slot = slot;
+    m_epoch = epoch;
+    m_slabCount = slabCount;
+    m_slabsBase = reserved.value();
+    m_slabs = reinterpret_cast<ThreadCacheSlab*>(slabs.value());
+    m_nextSlab.store(0, std::memory_order_relaxed);
+    m_caches.store(nullptr, std::memory_order_relaxed);
+    return true;
+}
+
+ThreadCache* ThreadCachingAllocator::getCache() {
+    ThreadCacheSlots& slots = tl_slots;
+    if (slots.epochs[m_slot] == m_epoch) {
+        return slots.caches[m_slot];
+    }
+
+    ThreadCache* cache = acquireCache();
+    if (cache != nullptr) {
+        slots.caches[m_slot] = cache;
+        slots.epochs[m_slot] = m_epoch;
+    }
+    return cache;
+}
+
+ThreadCache* ThreadCachingAllocator::acquireCache() {
+    // Adopt a cache which was left behind by a thread that has exited.
+    for (auto* cache = static_cast<ThreadCache*>(m_caches.load(std::memory_order_acquire)); cache; cache = cache->next) {
+        bool expected = false;
+        if (!cache->active.load(std::memory_order_relaxed) &&
+            cache->active.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return cache;
+        }
+    }
+
+    addr_size pageCount = pagesFor(sizeof(ThreadCache), m_pageSize);
+    auto res = core::allocPages(pageCount);
+    if (res.hasErr()) {
+        return nullptr;
+    }
+
+    ThreadCache* cache = new (res.value()) ThreadCache();
+    cache->active.store(true, std::memory_order_relaxed);
+    m_totalMemoryAllocated.fetch_add(pageCount * m_pageSize, std::memory_order_relaxed);
+
+    void* head = m_caches.load(std::memory_order_relaxed);
+    do {
+        cache->next = static_cast<ThreadCache*>(head);
+    } while (!m_caches.compare_exchange_weak(head, cache, std::memory_order_release, std::memory_order_relaxed));
+
+    return cache;
+}
+
+void* ThreadCachingAllocator::allocSmall(ThreadCache& cache, addr_size classIdx) {
+    addr_size blockSize = sizeClassBlockSize(classIdx);
+
+    // Fast path: reuse a block freed by this thread, or take over everything other threads have freed since.
+    void* head = cache.freeLists[classIdx];
+    if (head == nullptr && cache.remoteFrees[classIdx].load(std::memory_order_relaxed) != nullptr) {
+        head = cache.remoteFrees[classIdx].exchange(nullptr, std::memory_order_acquire);
+    }
+    if (head != nullptr) {
+        cache.freeLists[classIdx] = *reinterpret_cast<void**>(head);
+        addInUseMemory(cache, i64(blockSize));
+        return head;
+    }
+
+    // Carve a new block out of the slab which is assigned to this size class, or take a new slab from the shared range.
+    if (cache.carveCurr[classIdx] == cache.carveEnd[classIdx]) {
+        addr_size slabIdx = addr_size(m_nextSlab.fetch_add(1, std::memory_order_relaxed));
+        if (slabIdx >= m_slabCount) {
+            return nullptr;
+        }
+
+        void* slab = core::ptrAdvance(m_slabsBase, slabIdx * SLAB_SIZE);
+        if (core::commitPages(slab, SLAB_SIZE / m_pageSize).hasErr()) {
+            return nullptr;
+        }
+
+        m_slabs[slabIdx].owner = &cache;
+        m_slabs[slabIdx].classIdx = classIdx;
+        m_totalMemoryAllocated.fetch_add(SLAB_SIZE, std::memory_order_relaxed);
+
+        cache.carveCurr[classIdx] = slab;
+        cache.carveEnd[classIdx] = core::ptrAdvance(slab, SLAB_SIZE);
+    }
+
+    void* ret = cache.carveCurr[classIdx];
+    cache.carveCurr[classIdx] = core::ptrAdvance(ret, blockSize);
+    addInUseMemory(cache, i64(blockSize));
+    return ret;
+}
+
+void ThreadCachingAllocator::freeSmall(void* ptr, addr_size classIdx) {
+    addr_off offset = core::ptrDiff(ptr, m_slabsBase);
+    Assert(offset >= 0 && addr_size(offset) < m_slabCount * SLAB_SIZE, "Pointer was not allocated by this allocator");
+
+    ThreadCache* cache = getCache();
+    Panic(cache != nullptr, "Failed to allocate a thread cache");
+
+    const ThreadCacheSlab& slab = m_slabs[addr_size(offset) / SLAB_SIZE];
+    Assert(slab.classIdx == classIdx, "Freeing with a different size than allocated");
+
+    if (slab.owner == cache) {
+        *reinterpret_cast<void**>(ptr) = cache->freeLists[classIdx];
+        cache->freeLists[classIdx] = ptr;
+    }
+    else {
+        // Give the block back to the thread which owns the slab. Only the owner ever pops from this list, and it takes
+        // the whole list at once, so a plain push can't suffer from ABA.
+        core::AtomicPtr& remoteHead = slab.owner->remoteFrees[classIdx];
+        void* head = remoteHead.load(std::memory_order_relaxed);
+        do {
+            *reinterpret_cast<void**>(ptr) = head;
+        } while (!remoteHead.compare_exchange_weak(head, ptr, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // The memory is accounted for by the thread which frees it. Only the sum over all caches is meaningful.
+    addInUseMemory(*cache, -i64(sizeClassBlockSize(classIdx)));
+}
+
+void ThreadCachingAllocator::lockLargeBlocks() {
+    // Large allocations are rare and already pay for a system call, so a spin lock is good enough here.
+    while (m_largeBlocksLock.exchange(true, std::memory_order_acquire)) {
+        while (m_largeBlocksLock.load(std::memory_order_relaxed)) {}
+    }
+}
+
+void ThreadCachingAllocator::unlockLargeBlocks() {
+    m_largeBlocksLock.store(false, std::memory_order_release);
+}
+
+void* ThreadCachingAllocator::allocLarge(addr_size size, addr_size dataOffset) {
+    addr_size pageCount = pagesForLargeBlock(size, dataOffset, m_pageSize);
+    auto res = core::allocPages(pageCount);
+    if (res.hasErr()) {
+        if (oomHandler) {
+            oomHandler();
+        }
+        return nullptr;
+    }
+
+    ThreadCacheLargeBlock* block = reinterpret_cast<ThreadCacheLargeBlock*>(res.value());
+    block->prev = nullptr;
+    block->pageCount = pageCount;
+
+    lockLargeBlocks();
+    block->next = m_largeBlocks;
+    if (m_largeBlocks) {
+        m_largeBlocks->prev = block;
+    }
+    m_largeBlocks = block;
+    unlockLargeBlocks();
+
+    m_totalMemoryAllocated.fetch_add(pageCount * m_pageSize, std::memory_order_relaxed);
+    m_largeInUseMemory.fetch_add(size, std::memory_order_relaxed);
+    return core::ptrAdvance(block, dataOffset);
+}
+
+void ThreadCachingAllocator::freeLarge(void* ptr, addr_size size, addr_size dataOffset) {
+    ThreadCacheLargeBlock* block = reinterpret_cast<ThreadCacheLargeBlock*>(reinterpret_cast<u8*>(ptr) - dataOffset);
+
+    lockLargeBlocks();
+    if (block->prev) block->prev->next = block->next;
+    else m_largeBlocks = block->next;
+    if (block->next) block->next->prev = block->prev;
+    unlockLargeBlocks();
+
+    addr_size pageCount = block->pageCount;
+    Assert(pageCount == pagesForLargeBlock(size, dataOffset, m_pageSize), "Freeing with a different size than allocated");
+    m_totalMemoryAllocated.fetch_sub(pageCount * m_pageSize, std::memory_order_relaxed);
+    m_largeInUseMemory.fetch_sub(size, std::memory_order_relaxed);
+    core::freePages(block, pageCount);
+}
+
+void* ThreadCachingAllocator::alloc(addr_size count, addr_size size) {
+    Assert(count > 0 && size > 0, "Invalid Arguments");
+
+    addr_size effectiveSize = count * size;
+
+    if (effectiveSize > MAX_BLOCK_SIZE) {
+        return allocLarge(effectiveSize, LARGE_HEADER_SIZE);
+    }
+
+    ThreadCache* cache = ensureInitialized() ? getCache() : nullptr;
+    void* ret = cache ? allocSmall(*cache, sizeClassIdx(effectiveSize)) : nullptr;
+    if (ret == nullptr && oomHandler) {
+        oomHandler();
+    }
+    return ret;
+}
+
+void* ThreadCachingAllocator::allocAligned(addr_size count, addr_size size, addr_size alignment) {
+    Assert(count > 0 && size > 0, "Invalid Arguments");
+    Assert(core::ispow2(u32(alignment)), "Alignment must be a power of 2");
+    Assert(alignment <= m_pageSize, "Alignment can't be larger than the page size");
+
+    if (alignment <= LARGE_HEADER_SIZE) {
+        // Rounding the size up to the alignment selects a size class which is aligned well enough.
+        return alloc(core::core_max(count * size, alignment), 1);
+    }
+
+    return allocLarge(count * size, alignment);
+}
+
+void* ThreadCachingAllocator::calloc(addr_size count, addr_size size) {
+    void* ret = alloc(count, size);
+    if (ret) {
+        core::memset(reinterpret_cast<u8*>(ret), u8(0), count * size);
+    }
+    return ret;
+}
+
+void* ThreadCachingAllocator::realloc(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize) {
+    Assert(newCount > 0 && newSize > 0, "Invalid Argument");
+
+    addr_size newByteLen = newCount * newSize;
+    addr_size oldByteLen = oldCount * oldSize;
+
+    if (ptr == nullptr || oldByteLen == 0) {
+        return alloc(newCount, newSize);
+    }
+
+    if (newByteLen <= MAX_BLOCK_SIZE && oldByteLen <= MAX_BLOCK_SIZE &&
+        sizeClassIdx(newByteLen) == sizeClassIdx(oldByteLen)) {
+        // Still fits in the same block.
+        return ptr;
+    }
+
+    if (newByteLen > MAX_BLOCK_SIZE && oldByteLen > MAX_BLOCK_SIZE &&
+        pagesForLargeBlock(newByteLen, LARGE_HEADER_SIZE, m_pageSize) == pagesForLargeBlock(oldByteLen, LARGE_HEADER_SIZE, m_pageSize)) {
+        // Still fits in the same pages.
+        m_largeInUseMemory.fetch_add(newByteLen, std::memory_order_relaxed);
+        m_largeInUseMemory.fetch_sub(oldByteLen, std::memory_order_relaxed);
+        return ptr;
+    }
+
+    void* ret = alloc(newCount, newSize);
+    if (ret == nullptr) {
+        return nullptr;
+    }
+
+    addr_size copyLen = core::core_min(newByteLen, oldByteLen);
+    core::memcopy(reinterpret_cast<u8*>(ret), reinterpret_cast<const u8*>(ptr), copyLen);
+    free(ptr, oldCount, oldSize);
+    return ret;
+}
+
+void ThreadCachingAllocator::free(void* ptr, addr_size count, addr_size size) {
+    if (ptr == nullptr) {
+        return;
+    }
+
+    addr_size effectiveSize = count * size;
+    Assert(effectiveSize > 0, "Invalid Argument");
+
+    if (effectiveSize > MAX_BLOCK_SIZE) {
+        freeLarge(ptr, effectiveSize, LARGE_HEADER_SIZE);
+        return;
+    }
+
+    freeSmall(ptr, sizeClassIdx(effectiveSize));
+}
+
+void ThreadCachingAllocator::freeAligned(void* ptr, addr_size count, addr_size size, addr_size alignment) {
+    if (ptr == nullptr) {
+        return;
+    }
+
+    if (alignment <= LARGE_HEADER_SIZE) {
+        free(ptr, core::core_max(count * size, alignment), 1);
+        return;
+    }
+
+    freeLarge(ptr, count * size, alignment);
+}
+
+void ThreadCachingAllocator::clear() {
+    while (m_largeBlocks) {
+        ThreadCacheLargeBlock* next = m_largeBlocks->next;
+        core::freePages(m_largeBlocks, m_largeBlocks->pageCount);
+        m_largeBlocks = next;
+    }
+    m_largeInUseMemory.store(0, std::memory_order_relaxed);
+    m_totalMemoryAllocated.store(0, std::memory_order_relaxed);
+
+    if (m_state.load(std::memory_order_acquire) != STATE_READY) {
+        return;
+    }
+
+    addr_size cachePageCount = pagesFor(sizeof(ThreadCache), m_pageSize);
+    auto* cache = static_cast<ThreadCache*>(m_caches.load(std::memory_order_acquire));
+    while (cache) {
+        ThreadCache* next = cache->next;
+        core::freePages(cache, cachePageCount);
+        cache = next;
+    }
+
+    core::freePages(m_slabs, pagesFor(m_slabCount * sizeof(ThreadCacheSlab), m_pageSize));
+    core::freePages(m_slabsBase, m_reserveSize / m_pageSize);
+
+    // Threads still holding a cache of this allocator notice the epoch change and stop using it.
+    g_liveEpochs[m_slot].store(0, std::memory_order_release);
+
+    m_slabCount = 0;
+    m_slabsBase = nullptr;
+    m_slabs = nullptr;
+    m_nextSlab.store(0, std::memory_order_relaxed);
+    m_caches.store(nullptr, std::memory_order_relaxed);
+    m_state.store(STATE_UNINITIALIZED, std::memory_order_release);
+}
+
+addr_size ThreadCachingAllocator::totalMemoryAllocated() {
+    return addr_size(m_totalMemoryAllocated.load(std::memory_order_relaxed));
+}
+
+addr_size ThreadCachingAllocator::inUseMemory() {
+    i64 ret = i64(m_largeInUseMemory.load(std::memory_order_relaxed));
+    if (m_state.load(std::memory_order_acquire) == STATE_READY) {
+        for (auto* cache = static_cast<ThreadCache*>(m_caches.load(std::memory_order_acquire)); cache; cache = cache->next) {
+            ret += cache->inUseMemory.load(std::memory_order_relaxed);
+        }
+    }
+    return addr_size(ret);
+}
+
+} // namespace core
@@ -0,0 +1,339 @@
+#include <core_alloc.h>
+#include <core_cstr.h>
+#include <core_hash.h>
+#include <core_logger.h>
+#include <core_mem.h>
+
+#include <math/core_math.h>
+
+#include <plt/core_stacktrace.h>
+
+#include <cstdlib>
+
+namespace core {
+
+struct TracedAllocation {
+    void* ptr; // nullptr marks an empty slot
+    u32 siteIdx;
+    addr_size byteLen;
+};
+
+namespace {
+
+constexpr u32 EMPTY_SITE_SLOT = u32(-1);
+constexpr addr_size INITIAL_SITE_CAP = 32;
+constexpr addr_size INITIAL_LIVE_CAP = 256;
+constexpr const char* UNTAGGED_LABEL = "<untagged>";
+
+// Skips the frames of stacktrace, captureStackLabel and recordAlloc.
+constexpr i32 TRACER_SKIP_FRAMES = 3;
+
+thread_local const char* tl_allocationTag = nullptr;
+
+inline addr_size hashAddress(const void* ptr) {
+    // Finalizer of MurmurHash3, the low bits of an address are almost always zero.
+    u64 h = u64(reinterpret_cast<addr_size>(ptr));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return addr_size(h);
+}
+
+inline void lockTracer(core::AtomicBool& lock) {
+    while (lock.exchange(true, std::memory_order_acquire)) {
+        while (lock.load(std::memory_order_relaxed)) {}
+    }
+}
+
+inline void unlockTracer(core::AtomicBool& lock) {
+    lock.store(false, std::memory_order_release);
+}
+
+CORE_NEVER_INLINE addr_size captureStackLabel(char* out, u32 stackFrameCount) {
+    char buf[AllocationSite::MAX_LABEL_LEN * 2];
+    addr_size written = 0;
+    // A truncated trace is still good enough to tell the sites apart, so the result is ignored.
+    core::stacktrace(buf, sizeof(buf), written, i32(stackFrameCount), TRACER_SKIP_FRAMES);
+
+    // Drop the line with the thread name, otherwise the same site would show up once per thread.
+    addr_size start = 0;
+    while (start < written && buf[start] != '\n') start++;
+    start = (start < written) ? start + 1 : 0;
+
+    addr_size len = core::core_min(written - start, AllocationSite::MAX_LABEL_LEN - 1);
+    core::memcopy(out, buf + start, len);
+    out[len] = '\0';
+    return len;
+}
+
+inline bool isSameSite(const AllocationSite& site, u64 key, const char* label, addr_size labelLen) {
+    return site.key == key &&
+           core::memcmp(site.label, core::cstrLen(site.label), label, labelLen) == 0;
+}
+
+inline bool isMoreSignificant(const AllocationSite& a, const AllocationSite& b, AllocationSiteOrder order) {
+    switch (order) {
+        case AllocationSiteOrder::IN_USE_BYTES:    return a.inUseBytes > b.inUseBytes;
+        case AllocationSiteOrder::ALLOCATED_BYTES: return a.allocatedBytes > b.allocatedBytes;
+        case AllocationSiteOrder::ALLOC_COUNT:     return a.allocCount > b.allocCount;
+        case AllocationSiteOrder::SENTINEL:        break;
+    }
+    return false;
+}
+
+inline const char* orderToCptr(AllocationSiteOrder order) {
+    switch (order) {
+        case AllocationSiteOrder::IN_USE_BYTES:    return "in use bytes";
+        case AllocationSiteOrder::ALLOCATED_BYTES: return "allocated bytes";
+        case AllocationSiteOrder::ALLOC_COUNT:     return "allocation count";
+        case AllocationSiteOrder::SENTINEL:        break;
+    }
+    return "unknown";
+}
+
+} // namespace
+
+const char* setAllocationTag(const char* tag) {
+    const char* prev = tl_allocationTag;
+    tl_allocationTag = tag;
+    return prev;
+}
+
+AllocationTracer::AllocationTracer(u32 stackFrameCount)
+    : m_stackFrameCount(stackFrameCount)
+    , m_lock(false)
+    , m_sites(nullptr)
+    , m_siteCount(0)
+    , m_siteCap(0)
+    , m_siteSlots(nullptr)
+    , m_siteSlotsCap(0)
+    , m_live(nullptr)
+    , m_liveCount(0)
+    , m_liveCap(0) {}
+
+void AllocationTracer::recordAlloc(void* ptr, addr_size byteLen) {
+    // The label is built before taking the lock, capturing a stack trace is by far the slowest part of this.
+    char label[AllocationSite::MAX_LABEL_LEN];
+    addr_size labelLen;
+    if (const char* tag = tl_allocationTag; tag) {
+        labelLen = core::core_min(core::cstrLen(tag), AllocationSite::MAX_LABEL_LEN - 1);
+        core::memcopy(label, tag, labelLen);
+        label[labelLen] = '\0';
+    }
+    else if (m_stackFrameCount > 0) {
+        labelLen = captureStackLabel(label, m_stackFrameCount);
+    }
+    else {
+        labelLen = core::cstrLen(UNTAGGED_LABEL);
+        core::memcopy(label, UNTAGGED_LABEL, labelLen + 1);
+    }
+    u64 key = core::fnv1a_64(label, labelLen);
+
+    lockTracer(m_lock);
+    defer { unlockTracer(m_lock); };
+
+    // When the book-keeping itself runs out of memory the allocation is simply not traced.
+    u32 siteIdx = findOrAddSite(key, label, labelLen);
+    if (siteIdx == EMPTY_SITE_SLOT) return;
+    if ((m_liveCount + 1) * 2 > m_liveCap && !growLiveTable()) return;
+
+    AllocationSite& site = m_sites[siteIdx];
+    site.allocCount++;
+    site.allocatedBytes += byteLen;
+    site.inUseBytes += byteLen;
+
+    addr_size mask = m_liveCap - 1;
+    addr_size i = hashAddress(ptr) & mask;
+    while (m_live[i].ptr != nullptr && m_live[i].ptr != ptr) {
+        i = (i + 1) & mask;
+    }
+
+    if (m_live[i].ptr == ptr) {
+        // The allocator handed out the same address again without a free going through the tracer. This happens after
+        // the wrapped allocator was reset directly. The old entry is stale.
+        m_sites[m_live[i].siteIdx].inUseBytes -= m_live[i].byteLen;
+    }
+    else {
+        m_liveCount++;
+    }
+
+    m_live[i] = { ptr, siteIdx, byteLen };
+}
+
+void AllocationTracer::recordFree(void* ptr) {
+    lockTracer(m_lock);
+    defer { unlockTracer(m_lock); };
+
+    if (m_liveCount == 0) return;
+
+    addr_size mask = m_liveCap - 1;
+    addr_size i = hashAddress(ptr) & mask;
+    while (m_live[i].ptr != ptr) {
+        if (m_live[i].ptr == nullptr) return; // allocated before tracing started, or not traced at all
+        i = (i + 1) & mask;
+    }
+
+    AllocationSite& site = m_sites[m_live[i].siteIdx];
+    site.freeCount++;
+    site.inUseBytes -= m_live[i].byteLen;
+    m_liveCount--;
+
+    // Backward shift deletion, so that lookups never have to step over tombstones.
+    addr_size j = i;
+    while (true) {
+        j = (j + 1) & mask;
+        if (m_live[j].ptr == nullptr) break;
+
+        addr_size home = hashAddress(m_live[j].ptr) & mask;
+        bool canMove = (i <= j) ? (home <= i || home > j) : (home <= i && home > j);
+        if (canMove) {
+            m_live[i] = m_live[j];
+            i = j;
+        }
+    }
+    m_live[i].ptr = nullptr;
+}
+
+addr_size AllocationTracer::siteCount() {
+    lockTracer(m_lock);
+    defer { unlockTracer(m_lock); };
+    return m_siteCount;
+}
+
+addr_size AllocationTracer::topSites(AllocationSite* out, addr_size maxCount, AllocationSiteOrder order) {
+    lockTracer(m_lock);
+    defer { unlockTracer(m_lock); };
+
+    // Insertion into a sorted prefix. Only a handful of sites are ever asked for.
+    addr_size count = 0;
+    for (addr_size i = 0; i < m_siteCount; i++) {
+        const AllocationSite& site = m_sites[i];
+        addr_size pos = count;
+        while (pos > 0 && isMoreSignificant(site, out[pos - 1], order)) {
+            pos--;
+        }
+        if (pos >= maxCount) continue;
+
+        addr_size last = core::core_min(count, maxCount - 1);
+        for (addr_size k = last; k > pos; k--) {
+            out[k] = out[k - 1];
+        }
+        out[pos] = site;
+        if (count < maxCount) count++;
+    }
+
+    return count;
+}
+
+void AllocationTracer::logTopSites(addr_size maxCount, AllocationSiteOrder order) {
+    if (core::LogLevel::L_INFO < core::loggerGetLevel() || maxCount == 0) {
+        return;
+    }
+
+    // Copied out first, because the logger may very well allocate through the traced allocator.
+    AllocationSite* sites = reinterpret_cast<AllocationSite*>(std::malloc(maxCount * sizeof(AllocationSite)));
+    if (sites == nullptr) {
+        core::logDirectStd("Not enough memory to report the allocation sites\n");
+        return;
+    }
+    defer { std::free(sites); };
+
+    addr_size totalSites = siteCount();
+    addr_size count = topSites(sites, maxCount, order);
+
+    core::logDirectStd("--- Top {} of {} Allocation Sites by {} ---\n", count, totalSites, orderToCptr(order));
+    for (addr_size i = 0; i < count; i++) {
+        const AllocationSite& s = sites[i];
+        core::logDirectStd("#{} in use: {} bytes, allocated: {} bytes, allocs: {}, frees: {}\n",
+                           i + 1, s.inUseBytes, s.allocatedBytes, s.allocCount, s.freeCount);
+
+        addr_size labelLen = core::cstrLen(s.label);
+        bool endsWithNewLine = labelLen > 0 && s.label[labelLen - 1] == '\n';
+        core::logDirectStd(endsWithNewLine ? "{}" : "  {}\n", s.label);
+    }
+}
+
+void AllocationTracer::clear() {
+    std::free(m_sites);
+    std::free(m_siteSlots);
+    std::free(m_live);
+
+    m_sites = nullptr;
+    m_siteCount = 0;
+    m_siteCap = 0;
+    m_siteSlots = nullptr;
+    m_siteSlotsCap = 0;
+    m_live = nullptr;
+    m_liveCount = 0;
+    m_liveCap = 0;
+}
+
+u32 AllocationTracer::findOrAddSite(u64 key, const char* label, addr_size labelLen) {
+    if ((m_siteCount + 1) * 2 > m_siteSlotsCap) {
+        addr_size newSlotsCap = core::core_max(INITIAL_SITE_CAP * 2, m_siteSlotsCap * 2);
+        u32* newSlots = reinterpret_cast<u32*>(std::malloc(newSlotsCap * sizeof(u32)));
+        if (newSlots == nullptr) return EMPTY_SITE_SLOT;
+
+        core::memset(newSlots, EMPTY_SITE_SLOT, newSlotsCap);
+        for (addr_size i = 0; i < m_siteCount; i++) {
+            addr_size j = addr_size(m_sites[i].key) & (newSlotsCap - 1);
+            while (newSlots[j] != EMPTY_SITE_SLOT) {
+                j = (j + 1) & (newSlotsCap - 1);
+            }
+            newSlots[j] = u32(i);
+        }
+
+        std::free(m_siteSlots);
+        m_siteSlots = newSlots;
+        m_siteSlotsCap = newSlotsCap;
+    }
+
+    addr_size mask = m_siteSlotsCap - 1;
+    addr_size i = addr_size(key) & mask;
+    while (m_siteSlots[i] != EMPTY_SITE_SLOT) {
+        if (isSameSite(m_sites[m_siteSlots[i]], key, label, labelLen)) {
+            return m_siteSlots[i];
+        }
+        i = (i + 1) & mask;
+    }
+
+    if (m_siteCount == m_siteCap) {
+        addr_size newCap = core::core_max(INITIAL_SITE_CAP, m_siteCap * 2);
+        void* newSites = std::realloc(m_sites, newCap * sizeof(AllocationSite));
+        if (newSites == nullptr) return EMPTY_SITE_SLOT;
+        m_sites = reinterpret_cast<AllocationSite*>(newSites);
+        m_siteCap = newCap;
+    }
+
+    u32 siteIdx = u32(m_siteCount++);
+    AllocationSite& site = m_sites[siteIdx];
+    site = {};
+    site.key = key;
+    core::memcopy(site.label, label, labelLen);
+    site.label[labelLen] = '\0';
+
+    m_siteSlots[i] = siteIdx;
+    return siteIdx;
+}
+
+bool AllocationTracer::growLiveTable() {
+    addr_size newCap = core::core_max(INITIAL_LIVE_CAP, m_liveCap * 2);
+    TracedAllocation* newLive = reinterpret_cast<TracedAllocation*>(std::calloc(newCap, sizeof(TracedAllocation)));
+    if (newLive == nullptr) return false;
+
+    for (addr_size i = 0; i < m_liveCap; i++) {
+        if (m_live[i].ptr == nullptr) continue;
+        addr_size j = hashAddress(m_live[i].ptr) & (newCap - 1);
+        while (newLive[j].ptr != nullptr) {
+            j = (j + 1) & (newCap - 1);
+        }
+        newLive[j] = m_live[i];
+    }
+
+    std::free(m_live);
+    m_live = newLive;
+    m_liveCap = newCap;
+    return true;
+}
+
+} // namespace core
@@ -0,0 +1,214 @@
+#include <core_alloc.h>
+#include <core_assert.h>
+#include <core_mem.h>
+
+#include <math/core_math.h>
+
+#include <plt/core_pages.h>
+
+namespace core {
+
+namespace {
+
+inline addr_size alignPadding(const void* addr, addr_size alignment) {
+    return (addr_size(0) - reinterpret_cast<addr_size>(addr)) & (alignment - 1);
+}
+
+} // namespace
+
+VirtualArenaAllocator::VirtualArenaAllocator() : VirtualArenaAllocator(DEFAULT_RESERVE_SIZE) {}
+
+VirtualArenaAllocator::VirtualArenaAllocator(addr_size reserveSize)
+    : oomHandler(getDefaultOOMHandler())
+    , m_base(nullptr)
+    , m_curr(nullptr)
+    , m_reserveSize(0)
+    , m_committed(0)
+    , m_pageSize(core::getPageSize()) {
+    m_reserveSize = core::align(reserveSize, u32(m_pageSize));
+}
+
+VirtualArenaAllocator::VirtualArenaAllocator(VirtualArenaAllocator&& other) {
+    oomHandler = other.oomHandler;
+    m_base = other.m_base;
+    m_curr = other.m_curr;
+    m_reserveSize = other.m_reserveSize;
+    m_committed = other.m_committed;
+    m_pageSize = other.m_pageSize;
+
+    other.oomHandler = nullptr;
+    other.m_base = nullptr;
+    other.m_curr = nullptr;
+    other.m_reserveSize = 0;
+    other.m_committed = 0;
+}
+
+void VirtualArenaAllocator::setReserveSize(addr_size reserveSize) {
+    clear();
+    m_reserveSize = core::align(reserveSize, u32(m_pageSize));
+}
+
+bool VirtualArenaAllocator::reserve() {
+    if (m_base != nullptr) {
+        return true;
+    }
+
+    auto res = core::reservePages(m_reserveSize / m_pageSize);
+    if (res.hasErr()) {
+        return false;
+    }
+
+    m_base = res.value();
+    m_curr = m_base;
+    return true;
+}
+
+bool VirtualArenaAllocator::ensureCommitted(addr_size byteLen) {
+    if (byteLen <= m_committed) {
+        return true;
+    }
+    if (byteLen > m_reserveSize) {
+        return false;
+    }
+
+    // Commit in batches to keep the number of system calls down.
+    addr_size newCommitted = core::core_max(byteLen, m_committed + COMMIT_PAGE_COUNT * m_pageSize);
+    newCommitted = core::core_min(core::align(newCommitted, u32(m_pageSize)), m_reserveSize);
+
+    auto res = core::commitPages(core::ptrAdvance(m_base, m_committed), (newCommitted - m_committed) / m_pageSize);
+    if (res.hasErr()) {
+        return false;
+    }
+
+    m_committed = newCommitted;
+    return true;
+}
+
+bool VirtualArenaAllocator::isLastAllocation(const void* ptr, addr_size byteLen) {
+    return ptr != nullptr && core::ptrDiff(m_curr, ptr) == addr_off(core::align(byteLen));
+}
+
+void* VirtualArenaAllocator::alloc(addr_size count, addr_size size) {
+    return allocAligned(count, size, 1);
+}
+
+void* VirtualArenaAllocator::allocAligned(addr_size count, addr_size size, addr_size alignment) {
+    Assert(count > 0 && size > 0, "Invalid Arguments");
+    Assert(core::ispow2(u32(alignment)), "Alignment must be a power of 2");
+
+    addr_size effectiveSize = count * size;
+    if (effectiveSize > m_reserveSize || !reserve()) {
+        if (oomHandler) {
+            oomHandler();
+        }
+        return nullptr;
+    }
+
+    effectiveSize = core::align(effectiveSize);
+    addr_size padding = alignPadding(m_curr, alignment);
+    addr_size end = addr_size(core::ptrDiff(m_curr, m_base)) + padding + effectiveSize;
+    if (!ensureCommitted(end)) {
+        if (oomHandler) {
+            oomHandler();
+        }
+        return nullptr;
+    }
+
+    void* ret = core::ptrAdvance(m_curr, padding);
+    m_curr = core::ptrAdvance(m_base, end);
+    return ret;
+}
+
+void* VirtualArenaAllocator::calloc(addr_size count, addr_size size) {
+    void* ret = alloc(count, size);
+    if (ret) {
+        core::memset(reinterpret_cast<u8*>(ret), u8(0), core::align(count * size));
+    }
+    return ret;
+}
+
+void* VirtualArenaAllocator::realloc(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize) {
+    Assert(newCount > 0 && newSize > 0, "Invalid Argument");
+
+    addr_size newByteLen = newCount * newSize;
+    addr_size oldByteLen = oldCount * oldSize;
+
+    if (isLastAllocation(ptr, oldByteLen)) {
+        // Nothing follows the allocation, so it can always be resized in place. If that fails there is no room left for
+        // a copy either.
+        addr_size end = addr_size(core::ptrDiff(ptr, m_base)) + core::align(newByteLen);
+        if (newByteLen > m_reserveSize || !ensureCommitted(end)) {
+            if (oomHandler) {
+                oomHandler();
+            }
+            return nullptr;
+        }
+
+        m_curr = core::ptrAdvance(m_base, end);
+        return ptr;
+    }
+
+    void* ret = alloc(newCount, newSize);
+    addr_size copyLen = core::core_min(newByteLen, oldByteLen);
+    if (ret && ptr && copyLen > 0) {
+        core::memcopy(reinterpret_cast<u8*>(ret), reinterpret_cast<const u8*>(ptr), copyLen);
+    }
+    return ret;
+}
+
+void VirtualArenaAllocator::free(void* ptr, addr_size count, addr_size size) {
+    if (isLastAllocation(ptr, count * size)) {
+        m_curr = ptr;
+    }
+}
+
+void VirtualArenaAllocator::freeAligned(void* ptr, addr_size count, addr_size size, addr_size) {
+    free(ptr, count, size);
+}
+
+void VirtualArenaAllocator::clear() {
+    if (m_base != nullptr) {
+        core::freePages(m_base, m_reserveSize / m_pageSize);
+    }
+
+    m_base = nullptr;
+    m_curr = nullptr;
+    m_committed = 0;
+}
+
+addr_size VirtualArenaAllocator::totalMemoryAllocated() {
+    return m_committed;
+}
+
+addr_size VirtualArenaAllocator::inUseMemory() {
+    return addr_size(core::ptrDiff(m_curr, m_base));
+}
+
+AllocatorCheckpoint VirtualArenaAllocator::saveCheckpoint() {
+    AllocatorCheckpoint ret = {};
+    ret.data[0] = inUseMemory();
+    return ret;
+}
+
+void VirtualArenaAllocator::restoreCheckpoint(const AllocatorCheckpoint& checkpoint) {
+    Assert(checkpoint.data[0] <= inUseMemory(), "Checkpoints must be restored in reverse order");
+    m_curr = core::ptrAdvance(m_base, checkpoint.data[0]);
+}
+
+void VirtualArenaAllocator::reset(addr_size keepCommitted) {
+    m_curr = m_base;
+
+    if (m_base == nullptr || keepCommitted >= m_committed) {
+        return;
+    }
+
+    addr_size keep = core::align(keepCommitted, u32(m_pageSize));
+    if (keep < m_committed) {
+        auto res = core::decommitPages(core::ptrAdvance(m_base, keep), (m_committed - keep) / m_pageSize);
+        if (!res.hasErr()) {
+            m_committed = keep;
+        }
+    }
+}
+
+} // namespace core
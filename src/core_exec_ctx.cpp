@@ -3,8 +3,11 @@
 #include <core_alloc.h>
 #include <core_assert.h>
 #include <core_assert_fmt.h>
+#include <core_intrinsics.h>
 #include <core_logger.h>
 
+#include <math/core_math.h>
+
 #include <utility> // std::move aperantly is here.
 
 namespace core {
@@ -13,23 +16,97 @@ namespace {
 
 AllocatorContext g_defaultAllocatorContext;
 StdAllocator g_defaultStdAllocator;
+AllocatorStatsCounters g_defaultAllocatorStats;
 
 constexpr u32 MAX_REGISTERABLE_ALLOCATORS = 20;
 addr_size g_registeredAllocatorsCount = 0;
 AllocatorContext g_registeredAllocators[MAX_REGISTERABLE_ALLOCATORS] = {};
+AllocatorStatsCounters g_registeredAllocatorsStats[MAX_REGISTERABLE_ALLOCATORS];
 
 void zeroOutAllocatorContext(AllocatorContext& actx) {
     actx.nameFn = nullptr;
     actx.allocFn = nullptr;
+    actx.allocAlignedFn = nullptr;
     actx.callocFn = nullptr;
     actx.reallocFn = nullptr;
     actx.freeFn = nullptr;
+    actx.freeAlignedFn = nullptr;
     actx.clearFn = nullptr;
     actx.totalMemoryAllocatedFn = nullptr;
     actx.inUseMemoryFn = nullptr;
     actx.tracksMemoryFn = nullptr;
     actx.canDetectLeaksFn = nullptr;
+    actx.saveCheckpointFn = nullptr;
+    actx.restoreCheckpointFn = nullptr;
     actx.allocatorData = nullptr;
+    actx.statsCounters = nullptr;
+}
+
+void resetStatsCounters(AllocatorStatsCounters& c, u64 inUseBytes) {
+    c.allocCount.store(0, std::memory_order_relaxed);
+    c.freeCount.store(0, std::memory_order_relaxed);
+    c.reallocCount.store(0, std::memory_order_relaxed);
+    c.reallocCopyCount.store(0, std::memory_order_relaxed);
+    c.failedAllocCount.store(0, std::memory_order_relaxed);
+    c.inUseBytes.store(inUseBytes, std::memory_order_relaxed);
+    c.peakInUseBytes.store(inUseBytes, std::memory_order_relaxed);
+    for (addr_size i = 0; i < AllocatorStats::SIZE_HISTOGRAM_BUCKET_COUNT; i++) {
+        c.sizeHistogram[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+inline addr_size sizeHistogramBucket(addr_size byteLen) {
+    if (byteLen <= 1) {
+        return 0;
+    }
+    // ceil(log2(byteLen))
+    addr_size bucket = addr_size(sizeof(u64) * 8) - addr_size(core::intrin_countLeadingZeros(u64(byteLen - 1)));
+    return core::core_min(bucket, AllocatorStats::SIZE_HISTOGRAM_BUCKET_COUNT - 1);
+}
+
+inline void addInUseBytes(AllocatorStatsCounters& c, u64 byteLen) {
+    u64 inUse = c.inUseBytes.fetch_add(byteLen, std::memory_order_relaxed) + byteLen;
+    u64 peak = c.peakInUseBytes.load(std::memory_order_relaxed);
+    while (inUse > peak && !c.peakInUseBytes.compare_exchange_weak(peak, inUse, std::memory_order_relaxed)) {}
+}
+
+inline void recordAlloc(AllocatorStatsCounters& c, const void* ret, addr_size byteLen) {
+    if (ret == nullptr) {
+        c.failedAllocCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    c.allocCount.fetch_add(1, std::memory_order_relaxed);
+    c.sizeHistogram[sizeHistogramBucket(byteLen)].fetch_add(1, std::memory_order_relaxed);
+    addInUseBytes(c, byteLen);
+}
+
+inline void recordRealloc(AllocatorStatsCounters& c, const void* ptr, const void* ret, addr_size newByteLen, addr_size oldByteLen) {
+    if (ret == nullptr) {
+        c.failedAllocCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (ptr == nullptr) {
+        oldByteLen = 0;
+    }
+    c.reallocCount.fetch_add(1, std::memory_order_relaxed);
+    if (ptr != nullptr && ret != ptr) {
+        c.reallocCopyCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    c.sizeHistogram[sizeHistogramBucket(newByteLen)].fetch_add(1, std::memory_order_relaxed);
+    if (newByteLen >= oldByteLen) {
+        addInUseBytes(c, newByteLen - oldByteLen);
+    }
+    else {
+        c.inUseBytes.fetch_sub(oldByteLen - newByteLen, std::memory_order_relaxed);
+    }
+}
+
+inline void recordFree(AllocatorStatsCounters& c, const void* ptr, addr_size byteLen) {
+    if (ptr == nullptr) {
+        return;
+    }
+    c.freeCount.fetch_add(1, std::memory_order_relaxed);
+    c.inUseBytes.fetch_sub(byteLen, std::memory_order_relaxed);
 }
 
 } // namespace
@@ -42,15 +119,20 @@ AllocatorContext::AllocatorContext(void* _allocatorData) {
 AllocatorContext::AllocatorContext(AllocatorContext&& other) {
     nameFn = other.nameFn;
     allocFn = other.allocFn;
+    allocAlignedFn = other.allocAlignedFn;
     callocFn = other.callocFn;
     reallocFn = other.reallocFn;
     freeFn = other.freeFn;
+    freeAlignedFn = other.freeAlignedFn;
     clearFn = other.clearFn;
     totalMemoryAllocatedFn = other.totalMemoryAllocatedFn;
     inUseMemoryFn = other.inUseMemoryFn;
     tracksMemoryFn = other.tracksMemoryFn;
     canDetectLeaksFn = other.canDetectLeaksFn;
+    saveCheckpointFn = other.saveCheckpointFn;
+    restoreCheckpointFn = other.restoreCheckpointFn;
     allocatorData = other.allocatorData;
+    statsCounters = other.statsCounters;
 
     zeroOutAllocatorContext(other);
 }
@@ -58,15 +140,20 @@ AllocatorContext::AllocatorContext(AllocatorContext&& other) {
 AllocatorContext& AllocatorContext::operator=(AllocatorContext&& other) {
     nameFn = other.nameFn;
     allocFn = other.allocFn;
+    allocAlignedFn = other.allocAlignedFn;
     callocFn = other.callocFn;
     reallocFn = other.reallocFn;
     freeFn = other.freeFn;
+    freeAlignedFn = other.freeAlignedFn;
     clearFn = other.clearFn;
     totalMemoryAllocatedFn = other.totalMemoryAllocatedFn;
     inUseMemoryFn = other.inUseMemoryFn;
     tracksMemoryFn = other.tracksMemoryFn;
     canDetectLeaksFn = other.canDetectLeaksFn;
+    saveCheckpointFn = other.saveCheckpointFn;
+    restoreCheckpointFn = other.restoreCheckpointFn;
     allocatorData = other.allocatorData;
+    statsCounters = other.statsCounters;
 
     zeroOutAllocatorContext(other);
 
@@ -78,19 +165,49 @@ const char* AllocatorContext::name() {
 }
 
 void* AllocatorContext::alloc(addr_size count, addr_size size) {
-    return allocFn(allocatorData, count, size);
+    void* ret = allocFn(allocatorData, count, size);
+    if (statsCounters) {
+        recordAlloc(*statsCounters, ret, count * size);
+    }
+    return ret;
+}
+
+void* AllocatorContext::allocAligned(addr_size count, addr_size size, addr_size alignment) {
+    void* ret = allocAlignedFn(allocatorData, count, size, alignment);
+    if (statsCounters) {
+        recordAlloc(*statsCounters, ret, count * size);
+    }
+    return ret;
 }
 
 void* AllocatorContext::zeroAlloc(addr_size count, addr_size size) {
-    return callocFn(allocatorData, count, size);
+    void* ret = callocFn(allocatorData, count, size);
+    if (statsCounters) {
+        recordAlloc(*statsCounters, ret, count * size);
+    }
+    return ret;
 }
 
 void* AllocatorContext::reallocate(void* ptr, addr_size newCount, addr_size newSize, addr_size oldCount, addr_size oldSize) {
-    return reallocFn(allocatorData, ptr, newCount, newSize, oldCount, oldSize);
+    void* ret = reallocFn(allocatorData, ptr, newCount, newSize, oldCount, oldSize);
+    if (statsCounters) {
+        recordRealloc(*statsCounters, ptr, ret, newCount * newSize, oldCount * oldSize);
+    }
+    return ret;
 }
 
 void AllocatorContext::free(void* ptr, addr_size count, addr_size size) {
     freeFn(allocatorData, ptr, count, size);
+    if (statsCounters) {
+        recordFree(*statsCounters, ptr, count * size);
+    }
+}
+
+void AllocatorContext::freeAligned(void* ptr, addr_size count, addr_size size, addr_size alignment) {
+    freeAlignedFn(allocatorData, ptr, count, size, alignment);
+    if (statsCounters) {
+        recordFree(*statsCounters, ptr, count * size);
+    }
 }
 
 void AllocatorContext::clear() {
@@ -113,10 +230,72 @@ bool AllocatorContext::canDetectLeaks() {
     return canDetectLeaksFn(allocatorData);
 }
 
+bool AllocatorContext::supportsCheckpoints() {
+    return saveCheckpointFn != nullptr && restoreCheckpointFn != nullptr;
+}
+
+AllocatorCheckpoint AllocatorContext::saveCheckpoint() {
+    Panic(supportsCheckpoints(), "Allocator does not support checkpoints");
+    return saveCheckpointFn(allocatorData);
+}
+
+void AllocatorContext::restoreCheckpoint(const AllocatorCheckpoint& checkpoint) {
+    Panic(supportsCheckpoints(), "Allocator does not support checkpoints");
+    restoreCheckpointFn(allocatorData, checkpoint);
+}
+
+bool AllocatorContext::hasStats() {
+    return statsCounters != nullptr;
+}
+
+AllocatorStats AllocatorContext::stats() {
+    AllocatorStats ret = {};
+    if (statsCounters == nullptr) {
+        return ret;
+    }
+
+    const AllocatorStatsCounters& c = *statsCounters;
+    ret.allocCount = c.allocCount.load(std::memory_order_relaxed);
+    ret.freeCount = c.freeCount.load(std::memory_order_relaxed);
+    ret.reallocCount = c.reallocCount.load(std::memory_order_relaxed);
+    ret.reallocCopyCount = c.reallocCopyCount.load(std::memory_order_relaxed);
+    ret.failedAllocCount = c.failedAllocCount.load(std::memory_order_relaxed);
+    ret.inUseBytes = c.inUseBytes.load(std::memory_order_relaxed);
+    ret.peakInUseBytes = c.peakInUseBytes.load(std::memory_order_relaxed);
+    for (addr_size i = 0; i < AllocatorStats::SIZE_HISTOGRAM_BUCKET_COUNT; i++) {
+        ret.sizeHistogram[i] = c.sizeHistogram[i].load(std::memory_order_relaxed);
+    }
+    return ret;
+}
+
+void AllocatorContext::resetStats() {
+    if (statsCounters) {
+        resetStatsCounters(*statsCounters, statsCounters->inUseBytes.load(std::memory_order_relaxed));
+    }
+}
+
+AllocatorCheckpointScope::AllocatorCheckpointScope(AllocatorContext& actx)
+    : m_actx(actx.supportsCheckpoints() ? &actx : nullptr)
+    , m_checkpoint({}) {
+    if (m_actx) {
+        m_checkpoint = m_actx->saveCheckpoint();
+    }
+}
+
+AllocatorCheckpointScope::AllocatorCheckpointScope(AllocatorId id) : AllocatorCheckpointScope(getAllocator(id)) {}
+
+AllocatorCheckpointScope::~AllocatorCheckpointScope() {
+    if (m_actx) {
+        m_actx->restoreCheckpoint(m_checkpoint);
+    }
+}
+
 void initProgramCtx(GlobalAssertHandlerFn assertHandler,
                     LoggerCreateInfo* loggerCreateInfo) {
     core::setGlobalAssertHandler(assertHandler);
     g_defaultAllocatorContext = createAllocatorCtx(&g_defaultStdAllocator);
+    g_defaultAllocatorContext.statsCounters = &g_defaultAllocatorStats;
+    resetStatsCounters(g_defaultAllocatorStats, 0);
 
     if (loggerCreateInfo == nullptr) {
         Panic(core::loggerInit(), "Failed to init logger");
@@ -131,6 +310,8 @@ void initProgramCtx(GlobalAssertHandlerFn assertHandler,
                     AllocatorContext&& actx) {
     core::setGlobalAssertHandler(assertHandler);
     g_defaultAllocatorContext = std::move(actx);
+    g_defaultAllocatorContext.statsCounters = &g_defaultAllocatorStats;
+    resetStatsCounters(g_defaultAllocatorStats, 0);
 
     if (loggerCreateInfo == nullptr) {
         Panic(core::loggerInit(), "Failed to init logger");
@@ -164,6 +345,8 @@ void destroyProgramCtx(bool panicOnLeaks) {
 void registerAllocator(AllocatorContext&& ctx, AllocatorId id) {
     Panic(id - 1 < MAX_REGISTERABLE_ALLOCATORS);
     g_registeredAllocators[id - 1] = std::move(ctx);
+    g_registeredAllocators[id - 1].statsCounters = &g_registeredAllocatorsStats[id - 1];
+    resetStatsCounters(g_registeredAllocatorsStats[id - 1], 0);
     g_registeredAllocatorsCount++;
 }
 
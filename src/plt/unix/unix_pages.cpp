@@ -40,6 +40,51 @@ expected<PltErrCode> freePages(void* addr, addr_size count) {
     return {};
 }
 
+expected<void*, PltErrCode> reservePages(addr_size count) {
+    // MAP_NORESERVE - don't account the range against swap until it is committed.
+    i32 flags = ( MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE );
+    i32 prot = PROT_NONE;
+
+    void* addr = mmap(nullptr, count * PAGE_SIZE, prot, flags, -1, 0);
+    if (addr == MAP_FAILED || addr == nullptr) {
+        return core::unexpected(PltErrCode(errno));
+    }
+
+    return addr;
+}
+
+expected<PltErrCode> commitPages(void* addr, addr_size count) {
+    if (addr == nullptr) {
+        return core::unexpected(PltErrCode(EINVAL));
+    }
+
+    i32 err = mprotect(addr, count * PAGE_SIZE, PROT_READ | PROT_WRITE);
+    if (err != 0) {
+        return core::unexpected(PltErrCode(errno));
+    }
+
+    return {};
+}
+
+expected<PltErrCode> decommitPages(void* addr, addr_size count) {
+    if (addr == nullptr) {
+        return core::unexpected(PltErrCode(EINVAL));
+    }
+
+    // The pages are dropped first, so that the next commit sees zeroed memory.
+    i32 err = madvise(addr, count * PAGE_SIZE, MADV_DONTNEED);
+    if (err != 0) {
+        return core::unexpected(PltErrCode(errno));
+    }
+
+    err = mprotect(addr, count * PAGE_SIZE, PROT_NONE);
+    if (err != 0) {
+        return core::unexpected(PltErrCode(errno));
+    }
+
+    return {};
+}
+
 addr_size getPageSize() {
     addr_size ret = addr_size(sysconf(_SC_PAGESIZE));
     return ret;
@@ -33,6 +33,41 @@ expected<PltErrCode> freePages(void* addr, size_t) {
     return {};
 }
 
+expected<void*, PltErrCode> reservePages(size_t count) {
+    void* addr = VirtualAlloc(nullptr, count * PAGE_SIZE, MEM_RESERVE, PAGE_NOACCESS);
+    if (addr == nullptr) {
+        return core::unexpected(PltErrCode(GetLastError()));
+    }
+
+    return addr;
+}
+
+expected<PltErrCode> commitPages(void* addr, size_t count) {
+    if (addr == nullptr) {
+        return core::unexpected(PltErrCode(EINVAL));
+    }
+
+    void* res = VirtualAlloc(addr, count * PAGE_SIZE, MEM_COMMIT, PAGE_READWRITE);
+    if (res == nullptr) {
+        return core::unexpected(PltErrCode(GetLastError()));
+    }
+
+    return {};
+}
+
+expected<PltErrCode> decommitPages(void* addr, size_t count) {
+    if (addr == nullptr) {
+        return core::unexpected(PltErrCode(EINVAL));
+    }
+
+    BOOL err = VirtualFree(addr, count * PAGE_SIZE, MEM_DECOMMIT);
+    if (err == 0) {
+        return core::unexpected(PltErrCode(GetLastError()));
+    }
+
+    return {};
+}
+
 addr_size getPageSize() {
     SYSTEM_INFO si;
     GetSystemInfo(&si);
@@ -43,12 +43,13 @@ i32 bumpAllocatorBasicValidityTest() {
         }
     }
 
-    CT_CHECK(allocator.inUseMemory() == 128);
-    CT_CHECK(allocator.totalMemoryAllocated() == 128);
+    // Only the last allocation is given back.
+    CT_CHECK(allocator.inUseMemory() == 112);
+    CT_CHECK(allocator.totalMemoryAllocated() == 112);
 
     {
         allocator.oomHandler = nullptr;
-        void* data = allocator.alloc(1, 1);
+        void* data = allocator.alloc(17, 1);
         CT_CHECK(data == nullptr); // should be out of memory at this point.
     }
 
@@ -120,6 +121,104 @@ i32 bumpAllocatorReallocPreservesOverlappingBytesTest() {
     return 0;
 }
 
+i32 bumpAllocatorAlignedAllocTest() {
+    constexpr addr_size BUFF_SIZE = 256;
+    alignas(128) u8 buff[BUFF_SIZE];
+    core::BumpAllocator allocator(buff, BUFF_SIZE);
+
+    void* a = allocator.alloc(1, sizeof(u8));
+    CT_CHECK(a == buff);
+    CT_CHECK(allocator.inUseMemory() == 8);
+
+    void* b = allocator.allocAligned(1, 32, 64);
+    CT_CHECK(b == buff + 64, "Should skip to the next 64 byte boundary.");
+    CT_CHECK(allocator.inUseMemory() == 96, "The padding counts as used memory.");
+
+    void* c = allocator.allocAligned(1, 8, 8);
+    CT_CHECK(c == buff + 96, "Already aligned, no padding.");
+
+    // Does not fit after padding to the next 128 byte boundary.
+    allocator.oomHandler = nullptr;
+    void* d = allocator.allocAligned(1, 160, 128);
+    CT_CHECK(d == nullptr);
+    d = allocator.allocAligned(1, 8, 128);
+    CT_CHECK(d == buff + 128);
+
+    allocator.freeAligned(b, 1, 32, 64); // does nothing
+    CT_CHECK(allocator.inUseMemory() == 136);
+
+    return 0;
+}
+
+i32 bumpAllocatorResizeLastAllocationInPlaceTest() {
+    constexpr addr_size BUFF_SIZE = 256;
+    u8 buff[BUFF_SIZE] = {};
+    core::BumpAllocator allocator(buff, BUFF_SIZE);
+
+    u8* a = static_cast<u8*>(allocator.alloc(8, sizeof(u8)));
+    u8* b = static_cast<u8*>(allocator.alloc(4, sizeof(u8)));
+    for (addr_size i = 0; i < 4; ++i) {
+        b[i] = u8(i + 1);
+    }
+
+    // Growing the last allocation does not move it.
+    u8* grown = static_cast<u8*>(allocator.realloc(b, 100, sizeof(u8), 4, sizeof(u8)));
+    CT_CHECK(grown == b);
+    CT_CHECK(allocator.inUseMemory() == 8 + 104);
+    for (addr_size i = 0; i < 4; ++i) {
+        CT_CHECK(grown[i] == u8(i + 1));
+    }
+
+    // Neither does shrinking it.
+    u8* shrunk = static_cast<u8*>(allocator.realloc(grown, 10, sizeof(u8), 100, sizeof(u8)));
+    CT_CHECK(shrunk == b);
+    CT_CHECK(allocator.inUseMemory() == 8 + 16);
+
+    // Growing past the end of the buffer fails, without touching the allocation.
+    allocator.oomHandler = nullptr;
+    CT_CHECK(allocator.realloc(shrunk, BUFF_SIZE, sizeof(u8), 10, sizeof(u8)) == nullptr);
+    CT_CHECK(allocator.inUseMemory() == 8 + 16);
+
+    // Any other allocation has to be copied.
+    u8* moved = static_cast<u8*>(allocator.realloc(a, 16, sizeof(u8), 8, sizeof(u8)));
+    CT_CHECK(moved == b + 16);
+    CT_CHECK(allocator.inUseMemory() == 8 + 16 + 16);
+
+    // Freeing the last allocation gives the memory back, freeing anything else does nothing.
+    allocator.free(b, 10, sizeof(u8));
+    CT_CHECK(allocator.inUseMemory() == 8 + 16 + 16);
+    allocator.free(moved, 16, sizeof(u8));
+    CT_CHECK(allocator.inUseMemory() == 8 + 16);
+    allocator.free(b, 10, sizeof(u8));
+    CT_CHECK(allocator.inUseMemory() == 8);
+
+    return 0;
+}
+
+i32 bumpAllocatorCheckpointTest() {
+    constexpr addr_size BUFF_SIZE = 256;
+    alignas(64) u8 buff[BUFF_SIZE] = {};
+    core::BumpAllocator allocator(buff, BUFF_SIZE);
+
+    allocator.alloc(16, sizeof(u8));
+    core::AllocatorCheckpoint outer = allocator.saveCheckpoint();
+
+    allocator.alloc(32, sizeof(u8));
+    core::AllocatorCheckpoint inner = allocator.saveCheckpoint();
+    allocator.allocAligned(1, 8, 64);
+    allocator.alloc(100, sizeof(u8));
+    CT_CHECK(allocator.inUseMemory() == 64 + 8 + 104);
+
+    allocator.restoreCheckpoint(inner);
+    CT_CHECK(allocator.inUseMemory() == 16 + 32);
+
+    allocator.restoreCheckpoint(outer);
+    CT_CHECK(allocator.inUseMemory() == 16);
+    CT_CHECK(allocator.alloc(8, sizeof(u8)) == buff + 16);
+
+    return 0;
+}
+
 i32 runBumpAllocatorTestsSuite(const core::testing::TestSuiteInfo& sInfo) {
     using namespace core::testing;
 
@@ -136,6 +235,12 @@ i32 runBumpAllocatorTestsSuite(const core::testing::TestSuiteInfo& sInfo) {
     if (runTest(tInfo, onOomBumpAllocatorTest) != 0) { ret = -1; }
     tInfo.name = FN_NAME_TO_CPTR(bumpAllocatorReallocPreservesOverlappingBytesTest);
     if (runTest(tInfo, bumpAllocatorReallocPreservesOverlappingBytesTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(bumpAllocatorAlignedAllocTest);
+    if (runTest(tInfo, bumpAllocatorAlignedAllocTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(bumpAllocatorResizeLastAllocationInPlaceTest);
+    if (runTest(tInfo, bumpAllocatorResizeLastAllocationInPlaceTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(bumpAllocatorCheckpointTest);
+    if (runTest(tInfo, bumpAllocatorCheckpointTest) != 0) { ret = -1; }
 
     return ret;
 }
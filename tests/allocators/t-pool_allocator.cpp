@@ -0,0 +1,239 @@
+#include "../t-index.h"
+
+i32 poolAllocatorBasicValidityTest() {
+    core::PoolAllocator allocator;
+    defer { allocator.clear(); };
+
+    const addr_size slabSize = core::PoolAllocator::DEFAULT_SLAB_PAGE_COUNT * core::getPageSize();
+
+    {
+        void* data = allocator.alloc(4, sizeof(u8));
+        CT_CHECK(data != nullptr);
+        CT_CHECK(allocator.inUseMemory() == 16);
+        CT_CHECK(allocator.totalMemoryAllocated() == slabSize);
+        allocator.free(data, 4, sizeof(u8));
+        CT_CHECK(allocator.inUseMemory() == 0);
+    }
+
+    {
+        void* data = allocator.alloc(17, sizeof(u8));
+        CT_CHECK(data != nullptr);
+        CT_CHECK(allocator.inUseMemory() == 32);
+        CT_CHECK(allocator.totalMemoryAllocated() == slabSize * 2, "Every size class gets its own slab.");
+        allocator.free(data, 17, sizeof(u8));
+        CT_CHECK(allocator.inUseMemory() == 0);
+    }
+
+    {
+        void* data = allocator.alloc(core::PoolAllocator::MAX_BLOCK_SIZE, sizeof(u8));
+        CT_CHECK(data != nullptr);
+        CT_CHECK(allocator.inUseMemory() == core::PoolAllocator::MAX_BLOCK_SIZE);
+        allocator.free(data, core::PoolAllocator::MAX_BLOCK_SIZE, sizeof(u8));
+        CT_CHECK(allocator.inUseMemory() == 0);
+    }
+
+    allocator.clear();
+    CT_CHECK(allocator.inUseMemory() == 0);
+    CT_CHECK(allocator.totalMemoryAllocated() == 0);
+
+    return 0;
+}
+
+i32 poolAllocatorReusesFreedBlocksTest() {
+    core::PoolAllocator allocator;
+    defer { allocator.clear(); };
+
+    constexpr addr_size N = 64;
+    void* ptrs[N];
+
+    for (addr_size i = 0; i < N; i++) {
+        ptrs[i] = allocator.alloc(1, 48);
+        CT_CHECK(ptrs[i] != nullptr);
+        CT_CHECK(reinterpret_cast<addr_size>(ptrs[i]) % 16 == 0);
+        core::memset(reinterpret_cast<u8*>(ptrs[i]), u8(i), 48);
+    }
+
+    // Blocks must not overlap.
+    for (addr_size i = 0; i < N; i++) {
+        u8* p = reinterpret_cast<u8*>(ptrs[i]);
+        for (addr_size j = 0; j < 48; j++) {
+            CT_CHECK(p[j] == u8(i));
+        }
+    }
+
+    addr_size totalBefore = allocator.totalMemoryAllocated();
+
+    // Free every other block and allocate the same number again. No new slab should be needed and the freed addresses
+    // should be handed out again.
+    for (addr_size i = 0; i < N; i += 2) {
+        allocator.free(ptrs[i], 1, 48);
+    }
+    CT_CHECK(allocator.inUseMemory() == (N / 2) * 64);
+
+    for (addr_size i = 0; i < N; i += 2) {
+        void* p = allocator.alloc(48, 1);
+        bool found = false;
+        for (addr_size j = 0; j < N; j += 2) {
+            if (ptrs[j] == p) found = true;
+        }
+        CT_CHECK(found);
+    }
+
+    CT_CHECK(allocator.totalMemoryAllocated() == totalBefore);
+    CT_CHECK(allocator.inUseMemory() == N * 64);
+
+    return 0;
+}
+
+i32 poolAllocatorLargeAllocationsTest() {
+    core::PoolAllocator allocator;
+    defer { allocator.clear(); };
+
+    constexpr addr_size LARGE = core::PoolAllocator::MAX_BLOCK_SIZE + 1;
+
+    u8* a = reinterpret_cast<u8*>(allocator.calloc(LARGE, sizeof(u8)));
+    CT_CHECK(a != nullptr);
+    for (addr_size i = 0; i < LARGE; i++) {
+        CT_CHECK(a[i] == 0);
+    }
+    CT_CHECK(allocator.inUseMemory() == LARGE);
+
+    u8* b = reinterpret_cast<u8*>(allocator.alloc(3, core::CORE_MEGABYTE));
+    CT_CHECK(b != nullptr);
+    b[3 * core::CORE_MEGABYTE - 1] = 7;
+    CT_CHECK(allocator.inUseMemory() == LARGE + 3 * core::CORE_MEGABYTE);
+
+    allocator.free(a, LARGE, sizeof(u8));
+    CT_CHECK(allocator.inUseMemory() == 3 * core::CORE_MEGABYTE);
+
+    // Large blocks which are not freed are released by clear.
+    allocator.clear();
+    CT_CHECK(allocator.inUseMemory() == 0);
+    CT_CHECK(allocator.totalMemoryAllocated() == 0);
+
+    return 0;
+}
+
+i32 poolAllocatorReallocTest() {
+    core::PoolAllocator allocator;
+    defer { allocator.clear(); };
+
+    u8* data = reinterpret_cast<u8*>(allocator.alloc(20, sizeof(u8)));
+    for (addr_size i = 0; i < 20; i++) {
+        data[i] = u8(i + 1);
+    }
+
+    // Same size class, no move.
+    u8* grown = reinterpret_cast<u8*>(allocator.realloc(data, 30, sizeof(u8), 20, sizeof(u8)));
+    CT_CHECK(grown == data);
+    CT_CHECK(allocator.inUseMemory() == 32);
+
+    // Different size class, moves and preserves the bytes.
+    grown = reinterpret_cast<u8*>(allocator.realloc(grown, 4000, sizeof(u8), 30, sizeof(u8)));
+    CT_CHECK(grown != nullptr);
+    for (addr_size i = 0; i < 20; i++) {
+        CT_CHECK(grown[i] == u8(i + 1));
+    }
+    CT_CHECK(allocator.inUseMemory() == 4000);
+
+    u8* shrunk = reinterpret_cast<u8*>(allocator.realloc(grown, 10, sizeof(u8), 4000, sizeof(u8)));
+    for (addr_size i = 0; i < 10; i++) {
+        CT_CHECK(shrunk[i] == u8(i + 1));
+    }
+    CT_CHECK(allocator.inUseMemory() == 16);
+
+    allocator.free(shrunk, 10, sizeof(u8));
+    CT_CHECK(allocator.inUseMemory() == 0);
+
+    return 0;
+}
+
+i32 poolAllocatorMoveTest() {
+    core::PoolAllocator allocator;
+
+    void* data = allocator.alloc(4, sizeof(u8));
+
+    core::PoolAllocator allocator2 = std::move(allocator);
+    defer { allocator2.clear(); };
+
+    CT_CHECK(allocator.inUseMemory() == 0);
+    CT_CHECK(allocator.totalMemoryAllocated() == 0);
+
+    CT_CHECK(allocator2.inUseMemory() == 16);
+    allocator2.free(data, 4, sizeof(u8));
+    CT_CHECK(allocator2.inUseMemory() == 0);
+
+    return 0;
+}
+
+i32 onOomPoolAllocatorTest() {
+    static i32 testOOMCount = 0;
+    core::PoolAllocator allocator;
+    defer { allocator.clear(); };
+
+    CT_CHECK(allocator.oomHandler == core::getDefaultOOMHandler());
+
+    allocator.oomHandler = []() { testOOMCount++; };
+
+    void* data = allocator.alloc(0x7ffffffffffff, sizeof(u8));
+    CT_CHECK(data == nullptr);
+    CT_CHECK(testOOMCount == 1);
+
+    return 0;
+}
+
+i32 poolAllocatorAlignedAllocTest() {
+    core::PoolAllocator allocator;
+    defer { allocator.clear(); };
+
+    for (addr_size alignment = 1; alignment <= core::getPageSize(); alignment *= 2) {
+        for (addr_size size : { addr_size(1), addr_size(100), addr_size(5000) }) {
+            u8* data = reinterpret_cast<u8*>(allocator.allocAligned(size, sizeof(u8), alignment));
+            CT_CHECK(data != nullptr);
+            CT_CHECK(reinterpret_cast<addr_size>(data) % alignment == 0);
+            core::memset(data, u8(0xAB), size);
+            allocator.freeAligned(data, size, sizeof(u8), alignment);
+            CT_CHECK(allocator.inUseMemory() == 0);
+        }
+    }
+
+    // Up to 16 bytes the aligned and the plain entry points can be mixed.
+    void* data = allocator.allocAligned(3, sizeof(u8), 16);
+    CT_CHECK(allocator.inUseMemory() == 16);
+    allocator.free(data, 3, sizeof(u8));
+    CT_CHECK(allocator.inUseMemory() == 0);
+
+    // Stricter alignments get dedicated pages.
+    addr_size before = allocator.totalMemoryAllocated();
+    data = allocator.allocAligned(1, sizeof(u8), 128);
+    CT_CHECK(allocator.totalMemoryAllocated() == before + core::getPageSize());
+    allocator.freeAligned(data, 1, sizeof(u8), 128);
+    CT_CHECK(allocator.totalMemoryAllocated() == before);
+
+    return 0;
+}
+
+i32 runPoolAllocatorTestsSuite(const core::testing::TestSuiteInfo& sInfo) {
+    using namespace core::testing;
+
+    i32 ret = 0;
+    TestInfo tInfo = createTestInfo(sInfo);
+    tInfo.expectZeroAllocations = false;
+
+    tInfo.name = FN_NAME_TO_CPTR(poolAllocatorBasicValidityTest);
+    if (runTest(tInfo, poolAllocatorBasicValidityTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(poolAllocatorReusesFreedBlocksTest);
+    if (runTest(tInfo, poolAllocatorReusesFreedBlocksTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(poolAllocatorLargeAllocationsTest);
+    if (runTest(tInfo, poolAllocatorLargeAllocationsTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(poolAllocatorReallocTest);
+    if (runTest(tInfo, poolAllocatorReallocTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(poolAllocatorMoveTest);
+    if (runTest(tInfo, poolAllocatorMoveTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(onOomPoolAllocatorTest);
+    if (runTest(tInfo, onOomPoolAllocatorTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(poolAllocatorAlignedAllocTest);
+    if (runTest(tInfo, poolAllocatorAlignedAllocTest) != 0) { ret = -1; }
+
+    return ret;
+}
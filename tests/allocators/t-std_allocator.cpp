@@ -64,6 +64,22 @@ i32 onOOMStdAllocatorTest() {
     return 0;
 }
 
+i32 stdAllocatorAlignedAllocTest() {
+    core::StdAllocator allocator;
+
+    for (addr_size alignment = 1; alignment <= 4096; alignment *= 2) {
+        for (addr_size size : { addr_size(1), addr_size(24), addr_size(1000) }) {
+            u8* data = reinterpret_cast<u8*>(allocator.allocAligned(size, sizeof(u8), alignment));
+            CT_CHECK(data != nullptr);
+            CT_CHECK(reinterpret_cast<addr_size>(data) % alignment == 0);
+            core::memset(data, u8(0xAB), size);
+            allocator.freeAligned(data, size, sizeof(u8), alignment);
+        }
+    }
+
+    return 0;
+}
+
 i32 runStdAllocatorTestsSuite(const core::testing::TestSuiteInfo& sInfo) {
     using namespace core::testing;
 
@@ -76,6 +92,8 @@ i32 runStdAllocatorTestsSuite(const core::testing::TestSuiteInfo& sInfo) {
     if (runTest(tInfo, stdAllocatorBasicValidityTest) != 0) { ret = -1; }
     tInfo.name = FN_NAME_TO_CPTR(onOOMStdAllocatorTest);
     if (runTest(tInfo, onOOMStdAllocatorTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(stdAllocatorAlignedAllocTest);
+    if (runTest(tInfo, stdAllocatorAlignedAllocTest) != 0) { ret = -1; }
 
     return ret;
 }
@@ -128,6 +128,236 @@ i32 arenaAllocatorReallocPreservesOverlappingBytesTest() {
     return 0;
 }
 
+i32 arenaAllocatorManyBlocksTest() {
+    constexpr addr_size BLOCK_SIZE = 128;
+    constexpr addr_size BLOCK_COUNT = 1000;
+    core::StdArenaAllocator allocator(BLOCK_SIZE);
+    defer { allocator.clear(); };
+
+    // Every allocation takes a bit more than half of a block, so each one needs a new block and leaves a hole behind.
+    for (addr_size i = 0; i < BLOCK_COUNT; ++i) {
+        void* data = allocator.alloc(72, sizeof(u8));
+        CT_CHECK(data != nullptr);
+    }
+    CT_CHECK(allocator.totalMemoryAllocated() == BLOCK_SIZE * BLOCK_COUNT);
+    CT_CHECK(allocator.inUseMemory() == 72 * BLOCK_COUNT);
+
+    // Small allocations fill the holes that were left behind, instead of allocating new blocks.
+    for (addr_size i = 0; i < core::detail::ArenaState::PARTIAL_BLOCKS_MAX; ++i) {
+        void* data = allocator.alloc(56, sizeof(u8));
+        CT_CHECK(data != nullptr);
+    }
+    CT_CHECK(allocator.totalMemoryAllocated() == BLOCK_SIZE * BLOCK_COUNT);
+
+    // After a reset the owned blocks are reused in order.
+    allocator.reset();
+    CT_CHECK(allocator.inUseMemory() == 0);
+    for (addr_size i = 0; i < BLOCK_COUNT * 2; ++i) {
+        u8* data = reinterpret_cast<u8*>(allocator.alloc(64, sizeof(u8)));
+        CT_CHECK(data != nullptr);
+        core::memset(data, u8(i), 64);
+    }
+    CT_CHECK(allocator.totalMemoryAllocated() == BLOCK_SIZE * BLOCK_COUNT);
+    CT_CHECK(allocator.inUseMemory() == BLOCK_SIZE * BLOCK_COUNT);
+
+    return 0;
+}
+
+i32 arenaAllocatorOversizedAllocationsTest() {
+    constexpr addr_size BLOCK_SIZE = 64;
+    core::StdArenaAllocator allocator(BLOCK_SIZE);
+    defer { allocator.clear(); };
+
+    u8* small = reinterpret_cast<u8*>(allocator.alloc(8, sizeof(u8)));
+    CT_CHECK(small != nullptr);
+    CT_CHECK(allocator.totalMemoryAllocated() == BLOCK_SIZE);
+
+    u8* big = reinterpret_cast<u8*>(allocator.calloc(1000, sizeof(u8)));
+    CT_CHECK(big != nullptr);
+    CT_CHECK(reinterpret_cast<addr_size>(big) % 16 == 0);
+    for (addr_size i = 0; i < 1000; i++) {
+        CT_CHECK(big[i] == 0);
+        big[i] = u8(i);
+    }
+    CT_CHECK(allocator.inUseMemory() == 8 + 1000);
+    CT_CHECK(allocator.totalMemoryAllocated() == BLOCK_SIZE + 1000);
+
+    // Oversized allocations don't consume space in the regular blocks.
+    u8* small2 = reinterpret_cast<u8*>(allocator.alloc(8, sizeof(u8)));
+    CT_CHECK(small2 == small + 8);
+
+    // Growing past the block size moves the data into an oversized allocation.
+    u8* grown = reinterpret_cast<u8*>(allocator.realloc(big, 4000, sizeof(u8), 1000, sizeof(u8)));
+    CT_CHECK(grown != nullptr);
+    for (addr_size i = 0; i < 1000; i++) {
+        CT_CHECK(grown[i] == u8(i));
+    }
+    CT_CHECK(allocator.inUseMemory() == 16 + 1000 + 4000);
+
+    // Reset releases oversized allocations, but keeps the regular blocks.
+    allocator.reset();
+    CT_CHECK(allocator.inUseMemory() == 0);
+    CT_CHECK(allocator.totalMemoryAllocated() == BLOCK_SIZE);
+
+    allocator.alloc(2, core::CORE_KILOBYTE);
+    CT_CHECK(allocator.totalMemoryAllocated() == BLOCK_SIZE + 2 * core::CORE_KILOBYTE);
+
+    allocator.clear();
+    CT_CHECK(allocator.inUseMemory() == 0);
+    CT_CHECK(allocator.totalMemoryAllocated() == 0);
+
+    return 0;
+}
+
+i32 arenaAllocatorAlignedAllocTest() {
+    constexpr addr_size BLOCK_SIZE = 256;
+    core::StdArenaAllocator allocator(BLOCK_SIZE);
+    defer { allocator.clear(); };
+
+    for (addr_size alignment = 1; alignment <= 128; alignment *= 2) {
+        for (addr_size i = 0; i < 10; i++) {
+            allocator.alloc(1, sizeof(u8)); // knock the cursor off any boundary
+            u8* data = reinterpret_cast<u8*>(allocator.allocAligned(3, sizeof(u8), alignment));
+            CT_CHECK(data != nullptr);
+            CT_CHECK(reinterpret_cast<addr_size>(data) % alignment == 0);
+            core::memset(data, u8(0xAB), 3);
+        }
+    }
+
+    // Requests which might not fit in a block after padding are served with a dedicated allocation.
+    addr_size before = allocator.totalMemoryAllocated();
+    u8* big = reinterpret_cast<u8*>(allocator.allocAligned(BLOCK_SIZE, sizeof(u8), 64));
+    CT_CHECK(big != nullptr);
+    CT_CHECK(reinterpret_cast<addr_size>(big) % 64 == 0);
+    CT_CHECK(allocator.totalMemoryAllocated() == before + BLOCK_SIZE);
+    core::memset(big, u8(0xCD), BLOCK_SIZE);
+
+    u8* page = reinterpret_cast<u8*>(allocator.allocAligned(1, sizeof(u8), 4096));
+    CT_CHECK(reinterpret_cast<addr_size>(page) % 4096 == 0);
+
+    allocator.freeAligned(big, BLOCK_SIZE, sizeof(u8), 64); // does nothing
+
+    return 0;
+}
+
+i32 arenaAllocatorResizeLastAllocationInPlaceTest() {
+    constexpr addr_size BLOCK_SIZE = 256;
+    core::StdArenaAllocator allocator(BLOCK_SIZE);
+    defer { allocator.clear(); };
+
+    u8* a = static_cast<u8*>(allocator.alloc(8, sizeof(u8)));
+    u8* b = static_cast<u8*>(allocator.alloc(4, sizeof(u8)));
+    for (addr_size i = 0; i < 4; ++i) {
+        b[i] = u8(i + 1);
+    }
+
+    // Growing the last allocation of the block does not move it.
+    u8* grown = static_cast<u8*>(allocator.realloc(b, 200, sizeof(u8), 4, sizeof(u8)));
+    CT_CHECK(grown == b);
+    CT_CHECK(allocator.inUseMemory() == 8 + 200);
+    CT_CHECK(allocator.totalMemoryAllocated() == BLOCK_SIZE);
+
+    // Growing past the end of the block moves it to a new block and releases the old space.
+    u8* moved = static_cast<u8*>(allocator.realloc(grown, 250, sizeof(u8), 200, sizeof(u8)));
+    CT_CHECK(moved != b);
+    CT_CHECK(allocator.inUseMemory() == 8 + 256);
+    CT_CHECK(allocator.totalMemoryAllocated() == BLOCK_SIZE * 2);
+    for (addr_size i = 0; i < 4; ++i) {
+        CT_CHECK(moved[i] == u8(i + 1));
+    }
+
+    // The space left behind in the first block is reused.
+    u8* c = static_cast<u8*>(allocator.alloc(64, sizeof(u8)));
+    CT_CHECK(c == b);
+
+    // Freeing the last allocation of a block gives the memory back, freeing anything else does nothing.
+    allocator.free(a, 8, sizeof(u8));
+    CT_CHECK(allocator.inUseMemory() == 8 + 256 + 64);
+    allocator.free(c, 64, sizeof(u8));
+    CT_CHECK(allocator.inUseMemory() == 8 + 256);
+    allocator.free(moved, 250, sizeof(u8));
+    CT_CHECK(allocator.inUseMemory() == 8);
+
+    return 0;
+}
+
+i32 arenaAllocatorCheckpointTest() {
+    constexpr addr_size BLOCK_SIZE = 256;
+    core::StdArenaAllocator allocator(BLOCK_SIZE);
+    defer { allocator.clear(); };
+
+    u8* a = static_cast<u8*>(allocator.alloc(200, sizeof(u8)));
+    CT_CHECK(a != nullptr);
+
+    core::AllocatorCheckpoint outer = allocator.saveCheckpoint();
+
+    CT_CHECK(allocator.alloc(100, sizeof(u8)) != nullptr); // moves to a new block
+    CT_CHECK(allocator.alloc(48, sizeof(u8)) == a + 200); // fills the hole in the first block
+    CT_CHECK(allocator.alloc(1024, sizeof(u8)) != nullptr); // oversized
+    CT_CHECK(allocator.inUseMemory() == 352 + 1024);
+
+    {
+        core::AllocatorCheckpoint inner = allocator.saveCheckpoint();
+        CT_CHECK(allocator.alloc(BLOCK_SIZE, sizeof(u8)) != nullptr);
+        CT_CHECK(allocator.alloc(512, sizeof(u8)) != nullptr);
+        CT_CHECK(allocator.inUseMemory() == 352 + 1024 + BLOCK_SIZE + 512);
+
+        allocator.restoreCheckpoint(inner);
+        CT_CHECK(allocator.inUseMemory() == 352 + 1024);
+        CT_CHECK(allocator.totalMemoryAllocated() == BLOCK_SIZE * 3 + 1024);
+    }
+
+    allocator.restoreCheckpoint(outer);
+    CT_CHECK(allocator.inUseMemory() == 200);
+    CT_CHECK(allocator.totalMemoryAllocated() == BLOCK_SIZE * 3, "Blocks are kept, oversized allocations are released.");
+
+    // The rolled back memory is handed out again, without allocating new blocks.
+    CT_CHECK(allocator.alloc(48, sizeof(u8)) == a + 200);
+    CT_CHECK(allocator.alloc(100, sizeof(u8)) != nullptr);
+    CT_CHECK(allocator.alloc(BLOCK_SIZE, sizeof(u8)) != nullptr);
+    CT_CHECK(allocator.totalMemoryAllocated() == BLOCK_SIZE * 3);
+
+    return 0;
+}
+
+i32 allocatorCheckpointScopeTest() {
+    core::StdArenaAllocator allocator(256);
+    defer { allocator.clear(); };
+    core::AllocatorContext actx = core::createAllocatorCtx(&allocator);
+    CT_CHECK(actx.supportsCheckpoints());
+
+    void* callerData = actx.alloc(16, sizeof(u8));
+    CT_CHECK(callerData != nullptr);
+
+    {
+        core::AllocatorCheckpointScope scope(actx);
+        actx.alloc(100, sizeof(u8));
+
+        {
+            core::AllocatorCheckpointScope nested(actx);
+            actx.alloc(300, sizeof(u8));
+            CT_CHECK(actx.inUseMemory() == 16 + 104 + 304);
+        }
+
+        CT_CHECK(actx.inUseMemory() == 16 + 104);
+    }
+
+    CT_CHECK(actx.inUseMemory() == 16, "The caller's allocation survives.");
+
+    // Allocators without checkpoint support are left alone.
+    core::StdAllocator stdAllocator;
+    core::AllocatorContext stdCtx = core::createAllocatorCtx(&stdAllocator);
+    CT_CHECK(!stdCtx.supportsCheckpoints());
+    {
+        core::AllocatorCheckpointScope scope(stdCtx);
+        void* data = stdCtx.alloc(8, sizeof(u8));
+        CT_CHECK(data != nullptr);
+        stdCtx.free(data, 8, sizeof(u8));
+    }
+
+    return 0;
+}
+
 i32 runArenaAllocatorTestsSuite(const core::testing::TestSuiteInfo& sInfo) {
     using namespace core::testing;
 
@@ -143,6 +373,18 @@ i32 runArenaAllocatorTestsSuite(const core::testing::TestSuiteInfo& sInfo) {
     if (runTest(tInfo, onOomArenaAllocatorTest) != 0) { ret = -1; }
     tInfo.name = FN_NAME_TO_CPTR(arenaAllocatorReallocPreservesOverlappingBytesTest);
     if (runTest(tInfo, arenaAllocatorReallocPreservesOverlappingBytesTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(arenaAllocatorManyBlocksTest);
+    if (runTest(tInfo, arenaAllocatorManyBlocksTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(arenaAllocatorOversizedAllocationsTest);
+    if (runTest(tInfo, arenaAllocatorOversizedAllocationsTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(arenaAllocatorAlignedAllocTest);
+    if (runTest(tInfo, arenaAllocatorAlignedAllocTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(arenaAllocatorResizeLastAllocationInPlaceTest);
+    if (runTest(tInfo, arenaAllocatorResizeLastAllocationInPlaceTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(arenaAllocatorCheckpointTest);
+    if (runTest(tInfo, arenaAllocatorCheckpointTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(allocatorCheckpointScopeTest);
+    if (runTest(tInfo, allocatorCheckpointScopeTest) != 0) { ret = -1; }
 
     return ret;
 }
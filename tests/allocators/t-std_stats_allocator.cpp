@@ -116,6 +116,23 @@ i32 stdStatsAllocatorReallocAccountingTest() {
     return 0;
 }
 
+i32 stdStatsAllocatorAlignedAllocTest() {
+    core::StdStatsAllocator allocator;
+    defer { allocator.clear(); };
+
+    for (addr_size alignment = 1; alignment <= 4096; alignment *= 2) {
+        u8* data = reinterpret_cast<u8*>(allocator.allocAligned(100, sizeof(u8), alignment));
+        CT_CHECK(data != nullptr);
+        CT_CHECK(reinterpret_cast<addr_size>(data) % alignment == 0);
+        CT_CHECK(allocator.inUseMemory() == core::align(100));
+        core::memset(data, u8(0xAB), 100);
+        allocator.freeAligned(data, 100, sizeof(u8), alignment);
+        CT_CHECK(allocator.inUseMemory() == 0);
+    }
+
+    return 0;
+}
+
 i32 runStdStatsAllocatorTestsSuite(const core::testing::TestSuiteInfo& sInfo) {
     using namespace core::testing;
 
@@ -131,6 +148,8 @@ i32 runStdStatsAllocatorTestsSuite(const core::testing::TestSuiteInfo& sInfo) {
     if (runTest(tInfo, onOOMStdStatsAllocatorTest) != 0) { ret = -1; }
     tInfo.name = FN_NAME_TO_CPTR(stdStatsAllocatorReallocAccountingTest);
     if (runTest(tInfo, stdStatsAllocatorReallocAccountingTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(stdStatsAllocatorAlignedAllocTest);
+    if (runTest(tInfo, stdStatsAllocatorAlignedAllocTest) != 0) { ret = -1; }
 
     return ret;
 }
@@ -0,0 +1,281 @@
+#include "../t-index.h"
+
+#include <thread>
+
+namespace {
+
+using TCA = core::ThreadCachingAllocator;
+
+template <typename TFunc>
+i32 runOnThread(TFunc& fn) {
+    core::Thread t;
+    Expect(core::threadInit(t));
+    Expect(core::threadStart(t, reinterpret_cast<void*>(&fn), [](void* arg) {
+        (*reinterpret_cast<TFunc*>(arg))();
+    }));
+    Expect(core::threadJoin(t));
+    return 0;
+}
+
+// Cycles through every size class, with the occasional large allocation.
+addr_size stressItemSize(addr_size item) {
+    return (item % 17 == 0) ? TCA::MAX_BLOCK_SIZE + (item % 3) * 1000 : 8 + (item * 37) % TCA::MAX_BLOCK_SIZE;
+}
+
+} // namespace
+
+i32 threadCachingAllocatorBasicValidityTest() {
+    TCA allocator;
+    defer { allocator.clear(); };
+
+    CT_CHECK(allocator.inUseMemory() == 0);
+    CT_CHECK(allocator.totalMemoryAllocated() == 0);
+
+    void* a = allocator.alloc(1, 10);
+    CT_CHECK(a != nullptr);
+    CT_CHECK(allocator.inUseMemory() == 16, "Should be rounded up to the smallest size class.");
+    CT_CHECK(allocator.totalMemoryAllocated() >= TCA::SLAB_SIZE);
+
+    void* b = allocator.alloc(3, 100);
+    CT_CHECK(b != nullptr);
+    CT_CHECK(allocator.inUseMemory() == 16 + 512);
+
+    void* c = allocator.alloc(1, TCA::MAX_BLOCK_SIZE + 1);
+    CT_CHECK(c != nullptr);
+    CT_CHECK(allocator.inUseMemory() == 16 + 512 + TCA::MAX_BLOCK_SIZE + 1);
+
+    allocator.free(b, 3, 100);
+    CT_CHECK(allocator.inUseMemory() == 16 + TCA::MAX_BLOCK_SIZE + 1);
+
+    // The freed block is the first one to be reused.
+    void* d = allocator.alloc(1, 300);
+    CT_CHECK(d == b);
+
+    allocator.free(a, 1, 10);
+    allocator.free(c, 1, TCA::MAX_BLOCK_SIZE + 1);
+    allocator.free(d, 1, 300);
+    CT_CHECK(allocator.inUseMemory() == 0);
+
+    return 0;
+}
+
+i32 threadCachingAllocatorAlignedAllocTest() {
+    TCA allocator;
+    defer { allocator.clear(); };
+
+    constexpr addr_size alignments[] = { 16, 32, 64, 128, 1024 };
+    for (addr_size alignment : alignments) {
+        void* ptr = allocator.allocAligned(1, 8, alignment);
+        CT_CHECK(ptr != nullptr);
+        CT_CHECK((reinterpret_cast<addr_size>(ptr) & (alignment - 1)) == 0);
+        allocator.freeAligned(ptr, 1, 8, alignment);
+    }
+
+    CT_CHECK(allocator.inUseMemory() == 0);
+
+    return 0;
+}
+
+i32 threadCachingAllocatorReallocTest() {
+    TCA allocator;
+    defer { allocator.clear(); };
+
+    u8* data = static_cast<u8*>(allocator.alloc(20, sizeof(u8)));
+    for (addr_size i = 0; i < 20; i++) {
+        data[i] = u8(i);
+    }
+
+    // Same size class, nothing moves.
+    u8* same = static_cast<u8*>(allocator.realloc(data, 30, sizeof(u8), 20, sizeof(u8)));
+    CT_CHECK(same == data);
+
+    u8* grown = static_cast<u8*>(allocator.realloc(same, 4000, sizeof(u8), 30, sizeof(u8)));
+    CT_CHECK(grown != nullptr);
+    for (addr_size i = 0; i < 20; i++) {
+        CT_CHECK(grown[i] == u8(i));
+    }
+    CT_CHECK(allocator.inUseMemory() == 4000);
+
+    allocator.free(grown, 4000, sizeof(u8));
+    CT_CHECK(allocator.inUseMemory() == 0);
+
+    return 0;
+}
+
+i32 threadCachingAllocatorCrossThreadFreeTest() {
+    constexpr addr_size COUNT = 64;
+    constexpr addr_size SIZE = 32;
+
+    TCA allocator;
+    defer { allocator.clear(); };
+
+    // Make sure this thread has a cache of its own, otherwise it would adopt the one of the producer.
+    allocator.free(allocator.alloc(1, SIZE), 1, SIZE);
+
+    void* ptrs[COUNT] = {};
+    auto producer = [&]() {
+        for (addr_size i = 0; i < COUNT; i++) {
+            ptrs[i] = allocator.alloc(1, SIZE);
+        }
+    };
+    CT_CHECK(runOnThread(producer) == 0);
+    for (addr_size i = 0; i < COUNT; i++) {
+        CT_CHECK(ptrs[i] != nullptr);
+    }
+    CT_CHECK(allocator.inUseMemory() == COUNT * SIZE);
+
+    // Freed on a different thread than the one that allocated the blocks.
+    for (addr_size i = 0; i < COUNT; i++) {
+        allocator.free(ptrs[i], 1, SIZE);
+    }
+    CT_CHECK(allocator.inUseMemory() == 0);
+
+    // The producer has exited, the next thread adopts its cache and reuses the blocks which were sent back to it.
+    addr_size reused = 0;
+    auto consumer = [&]() {
+        for (addr_size i = 0; i < COUNT; i++) {
+            void* ptr = allocator.alloc(1, SIZE);
+            for (addr_size j = 0; j < COUNT; j++) {
+                if (ptrs[j] == ptr) {
+                    reused++;
+                    break;
+                }
+            }
+            allocator.free(ptr, 1, SIZE);
+        }
+    };
+    CT_CHECK(runOnThread(consumer) == 0);
+    CT_CHECK(reused == COUNT);
+    CT_CHECK(allocator.inUseMemory() == 0);
+
+    return 0;
+}
+
+i32 threadCachingAllocatorProducerConsumerStressTest() {
+    constexpr addr_size PAIR_COUNT = 4;
+    constexpr addr_size ITEM_COUNT = 20000;
+    constexpr addr_size RING_SIZE = 64;
+
+    struct Channel {
+        core::AtomicPtr ring[RING_SIZE];
+        TCA* allocator;
+        bool failed;
+    };
+
+    TCA allocator;
+    defer { allocator.clear(); };
+
+    Channel channels[PAIR_COUNT];
+    for (addr_size i = 0; i < PAIR_COUNT; i++) {
+        for (addr_size j = 0; j < RING_SIZE; j++) {
+            channels[i].ring[j].store(nullptr);
+        }
+        channels[i].allocator = &allocator;
+        channels[i].failed = false;
+    }
+
+    core::Thread producers[PAIR_COUNT];
+    core::Thread consumers[PAIR_COUNT];
+
+    for (addr_size i = 0; i < PAIR_COUNT; i++) {
+        Expect(core::threadInit(producers[i]));
+        Expect(core::threadInit(consumers[i]));
+
+        Expect(core::threadStart(consumers[i], &channels[i], [](void* arg) {
+            Channel& ch = *reinterpret_cast<Channel*>(arg);
+            for (addr_size item = 0; item < ITEM_COUNT; item++) {
+                core::AtomicPtr& slot = ch.ring[item % RING_SIZE];
+                void* ptr;
+                while ((ptr = slot.load(std::memory_order_acquire)) == nullptr) {
+                    std::this_thread::yield();
+                }
+                slot.store(nullptr, std::memory_order_release);
+
+                addr_size size = stressItemSize(item);
+                u8* bytes = reinterpret_cast<u8*>(ptr);
+                if (bytes[0] != u8(item) || bytes[size - 1] != u8(item)) {
+                    ch.failed = true;
+                }
+                ch.allocator->free(ptr, size, sizeof(u8));
+            }
+        }));
+
+        Expect(core::threadStart(producers[i], &channels[i], [](void* arg) {
+            Channel& ch = *reinterpret_cast<Channel*>(arg);
+            for (addr_size item = 0; item < ITEM_COUNT; item++) {
+                addr_size size = stressItemSize(item);
+                u8* bytes = reinterpret_cast<u8*>(ch.allocator->alloc(size, sizeof(u8)));
+                Panic(bytes != nullptr, "Out of memory"); // the consumer would wait forever
+                core::memset(bytes, u8(item), size);
+
+                core::AtomicPtr& slot = ch.ring[item % RING_SIZE];
+                while (slot.load(std::memory_order_acquire) != nullptr) {
+                    std::this_thread::yield();
+                }
+                slot.store(bytes, std::memory_order_release);
+            }
+        }));
+    }
+
+    for (addr_size i = 0; i < PAIR_COUNT; i++) {
+        Expect(core::threadJoin(producers[i]));
+        Expect(core::threadJoin(consumers[i]));
+        CT_CHECK(!channels[i].failed);
+    }
+
+    CT_CHECK(allocator.inUseMemory() == 0);
+
+    return 0;
+}
+
+i32 onOomThreadCachingAllocatorTest() {
+    static i32 testOOMCount = 0;
+    TCA allocator(TCA::SLAB_SIZE);
+    defer { allocator.clear(); };
+
+    core::OOMHandlerFn addr = core::getDefaultOOMHandler();
+    CT_CHECK(allocator.oomHandler == addr);
+
+    allocator.oomHandler = []() { testOOMCount++; };
+
+    // The only slab goes to the first size class.
+    addr_size blockCount = TCA::SLAB_SIZE / TCA::MIN_BLOCK_SIZE;
+    for (addr_size i = 0; i < blockCount; i++) {
+        CT_CHECK(allocator.alloc(1, TCA::MIN_BLOCK_SIZE) != nullptr);
+    }
+    CT_CHECK(testOOMCount == 0);
+
+    CT_CHECK(allocator.alloc(1, TCA::MIN_BLOCK_SIZE) == nullptr);
+    CT_CHECK(testOOMCount == 1);
+    CT_CHECK(allocator.alloc(1, 64) == nullptr);
+    CT_CHECK(testOOMCount == 2);
+
+    allocator.oomHandler = nullptr;
+    CT_CHECK(allocator.alloc(1, 64) == nullptr, "Setting the oomHandler to null is not properly handled.");
+
+    return 0;
+}
+
+i32 runThreadCachingAllocatorTestsSuite(const core::testing::TestSuiteInfo& sInfo) {
+    using namespace core::testing;
+
+    i32 ret = 0;
+
+    TestInfo tInfo = createTestInfo(sInfo);
+    tInfo.expectZeroAllocations = false;
+
+    tInfo.name = FN_NAME_TO_CPTR(threadCachingAllocatorBasicValidityTest);
+    if (runTest(tInfo, threadCachingAllocatorBasicValidityTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(threadCachingAllocatorAlignedAllocTest);
+    if (runTest(tInfo, threadCachingAllocatorAlignedAllocTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(threadCachingAllocatorReallocTest);
+    if (runTest(tInfo, threadCachingAllocatorReallocTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(threadCachingAllocatorCrossThreadFreeTest);
+    if (runTest(tInfo, threadCachingAllocatorCrossThreadFreeTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(threadCachingAllocatorProducerConsumerStressTest);
+    if (runTest(tInfo, threadCachingAllocatorProducerConsumerStressTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(onOomThreadCachingAllocatorTest);
+    if (runTest(tInfo, onOomThreadCachingAllocatorTest) != 0) { ret = -1; }
+
+    return ret;
+}
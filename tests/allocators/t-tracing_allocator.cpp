@@ -0,0 +1,250 @@
+#include "../t-index.h"
+
+namespace {
+
+using TracingStdAllocator = core::TracingAllocator<core::StdStatsAllocator>;
+
+const core::AllocationSite* findSite(const core::AllocationSite* sites, addr_size count, const char* label) {
+    for (addr_size i = 0; i < count; i++) {
+        if (core::cstrLen(sites[i].label) == core::cstrLen(label) && core::cstrCmpUnsafe(sites[i].label, label) == 0) {
+            return &sites[i];
+        }
+    }
+    return nullptr;
+}
+
+CORE_NEVER_INLINE void* allocFromFirstSite(TracingStdAllocator& allocator) {
+    return allocator.alloc(1, 32);
+}
+
+CORE_NEVER_INLINE void* allocFromSecondSite(TracingStdAllocator& allocator) {
+    return allocator.alloc(1, 64);
+}
+
+} // namespace
+
+i32 tracingAllocatorAttributesToTagsTest() {
+    core::StdStatsAllocator inner;
+    TracingStdAllocator allocator(inner);
+    defer { allocator.clear(); };
+
+    void* a[3] = {};
+    void* b = nullptr;
+    {
+        core::AllocationTagScope tag("A");
+        for (addr_size i = 0; i < 3; i++) {
+            a[i] = allocator.alloc(100, sizeof(u8));
+        }
+        {
+            core::AllocationTagScope nested("B");
+            b = allocator.alloc(1000, sizeof(u8));
+        }
+        allocator.free(a[0], 100, sizeof(u8));
+    }
+    CT_CHECK(core::setAllocationTag(nullptr) == nullptr, "The scopes restore the previous tag.");
+
+    CT_CHECK(allocator.tracer().siteCount() == 2);
+    CT_CHECK(allocator.inUseMemory() == inner.inUseMemory(), "Memory usage comes from the wrapped allocator.");
+
+    core::AllocationSite sites[4];
+    addr_size count = allocator.tracer().topSites(sites, 4);
+    CT_CHECK(count == 2);
+    CT_CHECK(core::cstrCmpUnsafe(sites[0].label, "B") == 0);
+    CT_CHECK(sites[0].inUseBytes == 1000);
+    CT_CHECK(sites[0].allocCount == 1);
+    CT_CHECK(core::cstrCmpUnsafe(sites[1].label, "A") == 0);
+    CT_CHECK(sites[1].inUseBytes == 200);
+    CT_CHECK(sites[1].allocatedBytes == 300);
+    CT_CHECK(sites[1].allocCount == 3);
+    CT_CHECK(sites[1].freeCount == 1);
+
+    count = allocator.tracer().topSites(sites, 1, core::AllocationSiteOrder::ALLOC_COUNT);
+    CT_CHECK(count == 1);
+    CT_CHECK(core::cstrCmpUnsafe(sites[0].label, "A") == 0);
+
+    allocator.free(a[1], 100, sizeof(u8));
+    allocator.free(a[2], 100, sizeof(u8));
+    allocator.free(b, 1000, sizeof(u8));
+
+    count = allocator.tracer().topSites(sites, 4);
+    CT_CHECK(count == 2);
+    CT_CHECK(sites[0].inUseBytes == 0);
+    CT_CHECK(sites[1].inUseBytes == 0);
+    CT_CHECK(allocator.inUseMemory() == 0);
+
+    return 0;
+}
+
+i32 tracingAllocatorReallocMovesOwnershipTest() {
+    core::StdStatsAllocator inner;
+    TracingStdAllocator allocator(inner);
+    defer { allocator.clear(); };
+
+    void* ptr = nullptr;
+    {
+        core::AllocationTagScope tag("creator");
+        ptr = allocator.alloc(16, sizeof(u32));
+    }
+    {
+        core::AllocationTagScope tag("grower");
+        ptr = allocator.realloc(ptr, 1024, sizeof(u32), 16, sizeof(u32));
+        CT_CHECK(ptr != nullptr);
+    }
+
+    core::AllocationSite sites[2];
+    addr_size count = allocator.tracer().topSites(sites, 2);
+    CT_CHECK(count == 2);
+
+    const core::AllocationSite* creator = findSite(sites, count, "creator");
+    const core::AllocationSite* grower = findSite(sites, count, "grower");
+    CT_CHECK(creator != nullptr && grower != nullptr);
+    CT_CHECK(creator->inUseBytes == 0);
+    CT_CHECK(creator->freeCount == 1);
+    CT_CHECK(grower->inUseBytes == 1024 * sizeof(u32));
+
+    // Frees do not depend on the current tag.
+    allocator.free(ptr, 1024, sizeof(u32));
+    count = allocator.tracer().topSites(sites, 2);
+    CT_CHECK(sites[0].inUseBytes == 0 && sites[1].inUseBytes == 0);
+
+    return 0;
+}
+
+i32 tracingAllocatorAttributesToStackTracesTest() {
+    core::StdStatsAllocator inner;
+    TracingStdAllocator allocator(inner);
+    defer { allocator.clear(); };
+
+    constexpr addr_size COUNT = 10;
+    void* first[COUNT] = {};
+    for (addr_size i = 0; i < COUNT; i++) {
+        first[i] = allocFromFirstSite(allocator);
+    }
+    void* second = allocFromSecondSite(allocator);
+
+    CT_CHECK(allocator.tracer().siteCount() == 2);
+
+    core::AllocationSite sites[2];
+    addr_size count = allocator.tracer().topSites(sites, 2, core::AllocationSiteOrder::ALLOC_COUNT);
+    CT_CHECK(count == 2);
+    CT_CHECK(sites[0].allocCount == COUNT);
+    CT_CHECK(sites[0].inUseBytes == COUNT * 32);
+    CT_CHECK(sites[1].allocCount == 1);
+    CT_CHECK(sites[1].inUseBytes == 64);
+    CT_CHECK(core::cstrLen(sites[0].label) > 0);
+
+    for (addr_size i = 0; i < COUNT; i++) {
+        allocator.free(first[i], 1, 32);
+    }
+    allocator.free(second, 1, 64);
+
+    return 0;
+}
+
+i32 tracingAllocatorWithoutStackTracesTest() {
+    core::StdStatsAllocator inner;
+    TracingStdAllocator allocator(inner, 0);
+    defer { allocator.clear(); };
+
+    // Enough allocations to grow the book-keeping a few times.
+    constexpr addr_size COUNT = 2000;
+    void* ptrs[COUNT] = {};
+    for (addr_size i = 0; i < COUNT; i++) {
+        ptrs[i] = allocFromFirstSite(allocator);
+        CT_CHECK(ptrs[i] != nullptr);
+    }
+    void* tagged = nullptr;
+    {
+        core::AllocationTagScope tag("tagged");
+        tagged = allocFromSecondSite(allocator);
+    }
+
+    core::AllocationSite sites[2];
+    addr_size count = allocator.tracer().topSites(sites, 2);
+    CT_CHECK(count == 2);
+    CT_CHECK(core::cstrCmpUnsafe(sites[0].label, "<untagged>") == 0);
+    CT_CHECK(sites[0].allocCount == COUNT);
+    CT_CHECK(sites[0].inUseBytes == COUNT * 32);
+
+    // Freeing in a different order than the allocation exercises the removal from the address table.
+    for (addr_size i = 0; i < COUNT; i += 2) {
+        allocator.free(ptrs[i], 1, 32);
+    }
+    for (addr_size i = 1; i < COUNT; i += 2) {
+        allocator.free(ptrs[i], 1, 32);
+    }
+    allocator.free(tagged, 1, 64);
+
+    count = allocator.tracer().topSites(sites, 2);
+    CT_CHECK(sites[0].inUseBytes == 0 && sites[1].inUseBytes == 0);
+    CT_CHECK(findSite(sites, count, "<untagged>")->freeCount == COUNT);
+    CT_CHECK(allocator.inUseMemory() == 0);
+
+    return 0;
+}
+
+i32 tracingAllocatorThroughAllocatorContextTest() {
+    core::StdStatsAllocator inner;
+    TracingStdAllocator allocator(inner, 0);
+    defer { allocator.clear(); };
+
+    core::AllocatorContext actx = core::createAllocatorCtx(&allocator);
+    CT_CHECK(core::cstrCmpUnsafe(actx.name(), inner.name()) == 0);
+
+    void* ptr = nullptr;
+    {
+        core::AllocationTagScope tag("ctx");
+        ptr = actx.zeroAlloc(8, sizeof(u64));
+    }
+    CT_CHECK(ptr != nullptr);
+
+    core::AllocationSite site;
+    CT_CHECK(allocator.tracer().topSites(&site, 1) == 1);
+    CT_CHECK(core::cstrCmpUnsafe(site.label, "ctx") == 0);
+    CT_CHECK(site.inUseBytes == 64);
+
+    {
+        static bool reportedTag = false;
+        reportedTag = false;
+
+        core::LoggerCreateInfo createInfo = core::LoggerCreateInfo::createDefault();
+        createInfo.print = [](core::StrView message) {
+            if (message.len() >= 5 && core::memcmp(message.data(), "  ctx", 5) == 0) reportedTag = true;
+        };
+        CT_CHECK(core::loggerInit(createInfo) == true);
+        defer { core::loggerDestroy(); };
+
+        allocator.tracer().logTopSites(5);
+        CT_CHECK(reportedTag);
+    }
+
+    actx.free(ptr, 8, sizeof(u64));
+    CT_CHECK(actx.inUseMemory() == 0);
+
+    return 0;
+}
+
+i32 runTracingAllocatorTestsSuite(const core::testing::TestSuiteInfo& sInfo) {
+    using namespace core::testing;
+
+    i32 ret = 0;
+
+    TestInfo tInfo = createTestInfo(sInfo);
+    tInfo.expectZeroAllocations = false;
+
+    tInfo.name = FN_NAME_TO_CPTR(tracingAllocatorAttributesToTagsTest);
+    if (runTest(tInfo, tracingAllocatorAttributesToTagsTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(tracingAllocatorReallocMovesOwnershipTest);
+    if (runTest(tInfo, tracingAllocatorReallocMovesOwnershipTest) != 0) { ret = -1; }
+    #if defined(CORE_DEBUG) && CORE_DEBUG == 1
+        // Stacktrace should only be expected to work in debug builds.
+        tInfo.name = FN_NAME_TO_CPTR(tracingAllocatorAttributesToStackTracesTest);
+        if (runTest(tInfo, tracingAllocatorAttributesToStackTracesTest) != 0) { ret = -1; }
+    #endif
+    tInfo.name = FN_NAME_TO_CPTR(tracingAllocatorWithoutStackTracesTest);
+    if (runTest(tInfo, tracingAllocatorWithoutStackTracesTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(tracingAllocatorThroughAllocatorContextTest);
+    if (runTest(tInfo, tracingAllocatorThroughAllocatorContextTest) != 0) { ret = -1; }
+
+    return ret;
+}
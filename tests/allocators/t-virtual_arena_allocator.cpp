@@ -0,0 +1,239 @@
+#include "../t-index.h"
+
+i32 virtualArenaAllocatorBasicValidityTest() {
+    const addr_size pageSize = core::getPageSize();
+    core::VirtualArenaAllocator allocator(pageSize * 64);
+    defer { allocator.clear(); };
+
+    // Nothing is reserved or committed before the first allocation.
+    CT_CHECK(allocator.inUseMemory() == 0);
+    CT_CHECK(allocator.totalMemoryAllocated() == 0);
+
+    {
+        void* data = allocator.alloc(4, sizeof(u8));
+        CT_CHECK(data != nullptr);
+        CT_CHECK(allocator.inUseMemory() == 8);
+        CT_CHECK(allocator.totalMemoryAllocated() == core::VirtualArenaAllocator::COMMIT_PAGE_COUNT * pageSize);
+    }
+
+    {
+        void* data = allocator.alloc(9, sizeof(u8));
+        CT_CHECK(data != nullptr);
+        CT_CHECK(allocator.inUseMemory() == 24);
+    }
+
+    {
+        // Crossing the committed range commits another batch.
+        addr_size committed = allocator.totalMemoryAllocated();
+        u8* data = static_cast<u8*>(allocator.alloc(committed, sizeof(u8)));
+        CT_CHECK(data != nullptr);
+        CT_CHECK(allocator.totalMemoryAllocated() > committed);
+        data[0] = 1;
+        data[committed - 1] = 1;
+    }
+
+    {
+        u8* data = static_cast<u8*>(allocator.calloc(32, sizeof(u8)));
+        CT_CHECK(data != nullptr);
+        for (addr_size i = 0; i < 32; i++) {
+            CT_CHECK(data[i] == 0);
+        }
+    }
+
+    return 0;
+}
+
+i32 virtualArenaAllocatorGrowLastAllocationInPlaceTest() {
+    const addr_size pageSize = core::getPageSize();
+    core::VirtualArenaAllocator allocator(pageSize * 256);
+    defer { allocator.clear(); };
+
+    allocator.alloc(16, sizeof(u8));
+
+    u32* data = static_cast<u32*>(allocator.alloc(4, sizeof(u32)));
+    CT_CHECK(data != nullptr);
+    addr_size count = 4;
+    for (addr_size i = 0; i < count; i++) {
+        data[i] = u32(i);
+    }
+
+    // Keep doubling well past the first commit batch, the address never changes.
+    while (count * sizeof(u32) < pageSize * 128) {
+        u32* grown = static_cast<u32*>(allocator.realloc(data, count * 2, sizeof(u32), count, sizeof(u32)));
+        CT_CHECK(grown == data);
+        for (addr_size i = count; i < count * 2; i++) {
+            grown[i] = u32(i);
+        }
+        count *= 2;
+    }
+
+    for (addr_size i = 0; i < count; i++) {
+        CT_CHECK(data[i] == u32(i));
+    }
+    CT_CHECK(allocator.inUseMemory() == 16 + count * sizeof(u32));
+
+    // Shrinking in place gives the tail back.
+    u32* shrunk = static_cast<u32*>(allocator.realloc(data, 4, sizeof(u32), count, sizeof(u32)));
+    CT_CHECK(shrunk == data);
+    CT_CHECK(allocator.inUseMemory() == 16 + 16);
+
+    // Freeing the last allocation rewinds the cursor.
+    allocator.free(shrunk, 4, sizeof(u32));
+    CT_CHECK(allocator.inUseMemory() == 16);
+
+    return 0;
+}
+
+i32 virtualArenaAllocatorAlignedAllocTest() {
+    core::VirtualArenaAllocator allocator(core::getPageSize() * 16);
+    defer { allocator.clear(); };
+
+    void* a = allocator.alloc(1, sizeof(u8));
+    CT_CHECK(a != nullptr);
+    CT_CHECK(allocator.inUseMemory() == 8);
+
+    void* b = allocator.allocAligned(1, 32, 64);
+    CT_CHECK(b != nullptr);
+    CT_CHECK((reinterpret_cast<addr_size>(b) & 63) == 0);
+    CT_CHECK(allocator.inUseMemory() == 96, "The padding counts as used memory.");
+
+    void* c = allocator.allocAligned(3, 8, 256);
+    CT_CHECK(c != nullptr);
+    CT_CHECK((reinterpret_cast<addr_size>(c) & 255) == 0);
+    CT_CHECK(allocator.inUseMemory() == 256 + 24);
+
+    allocator.freeAligned(c, 3, 8, 256);
+    CT_CHECK(allocator.inUseMemory() == 256);
+
+    return 0;
+}
+
+i32 virtualArenaAllocatorResetTest() {
+    const addr_size pageSize = core::getPageSize();
+    const addr_size batchSize = core::VirtualArenaAllocator::COMMIT_PAGE_COUNT * pageSize;
+    core::VirtualArenaAllocator allocator(batchSize * 4);
+    defer { allocator.clear(); };
+
+    u8* first = static_cast<u8*>(allocator.alloc(batchSize * 3, sizeof(u8)));
+    CT_CHECK(first != nullptr);
+    core::memset(first, u8(0xAB), batchSize * 3);
+    CT_CHECK(allocator.totalMemoryAllocated() == batchSize * 3);
+
+    // Resetting without a limit keeps everything committed.
+    allocator.reset();
+    CT_CHECK(allocator.inUseMemory() == 0);
+    CT_CHECK(allocator.totalMemoryAllocated() == batchSize * 3);
+
+    u8* second = static_cast<u8*>(allocator.alloc(batchSize * 3, sizeof(u8)));
+    CT_CHECK(second == first);
+    CT_CHECK(second[batchSize * 2] == 0xAB, "Memory that stays committed is not touched.");
+
+    // Resetting with a limit returns the pages above it to the OS, they come back zeroed.
+    allocator.reset(batchSize);
+    CT_CHECK(allocator.inUseMemory() == 0);
+    CT_CHECK(allocator.totalMemoryAllocated() == batchSize);
+
+    u8* third = static_cast<u8*>(allocator.alloc(batchSize * 3, sizeof(u8)));
+    CT_CHECK(third == first);
+    CT_CHECK(third[0] == 0xAB);
+    CT_CHECK(third[batchSize] == 0);
+    CT_CHECK(third[batchSize * 3 - 1] == 0);
+
+    return 0;
+}
+
+i32 virtualArenaAllocatorCheckpointTest() {
+    const addr_size batchSize = core::VirtualArenaAllocator::COMMIT_PAGE_COUNT * core::getPageSize();
+    core::VirtualArenaAllocator allocator(batchSize * 4);
+    defer { allocator.clear(); };
+
+    u8* a = static_cast<u8*>(allocator.alloc(16, sizeof(u8)));
+    core::AllocatorCheckpoint checkpoint = allocator.saveCheckpoint();
+
+    CT_CHECK(allocator.alloc(batchSize * 2, sizeof(u8)) != nullptr);
+    CT_CHECK(allocator.totalMemoryAllocated() > batchSize);
+
+    allocator.restoreCheckpoint(checkpoint);
+    CT_CHECK(allocator.inUseMemory() == 16);
+    CT_CHECK(allocator.totalMemoryAllocated() > batchSize, "Restoring keeps the memory committed.");
+    CT_CHECK(allocator.alloc(8, sizeof(u8)) == a + 16);
+
+    return 0;
+}
+
+i32 virtualArenaAllocatorMoveTest() {
+    core::VirtualArenaAllocator allocator(core::getPageSize() * 16);
+
+    allocator.alloc(4, sizeof(u8));
+
+    core::VirtualArenaAllocator allocator2 = std::move(allocator);
+    defer { allocator2.clear(); };
+
+    CT_CHECK(allocator.inUseMemory() == 0);
+    CT_CHECK(allocator.totalMemoryAllocated() == 0);
+
+    CT_CHECK(allocator2.inUseMemory() == 8);
+    CT_CHECK(allocator2.totalMemoryAllocated() > 0);
+
+    return 0;
+}
+
+i32 onOomVirtualArenaAllocatorTest() {
+    static i32 testOOMCount = 0;
+    const addr_size reserveSize = core::getPageSize() * 4;
+    core::VirtualArenaAllocator allocator(reserveSize);
+    defer { allocator.clear(); };
+
+    core::OOMHandlerFn addr = core::getDefaultOOMHandler();
+    CT_CHECK(allocator.oomHandler == addr);
+
+    allocator.oomHandler = []() { testOOMCount++; };
+
+    void* data = allocator.alloc(reserveSize + 1, sizeof(u8));
+    CT_CHECK(data == nullptr);
+    CT_CHECK(testOOMCount == 1);
+
+    // The commit batch is clamped to the reservation.
+    data = allocator.alloc(reserveSize, sizeof(u8));
+    CT_CHECK(data != nullptr);
+    CT_CHECK(allocator.totalMemoryAllocated() == reserveSize);
+
+    CT_CHECK(allocator.realloc(data, reserveSize + 8, sizeof(u8), reserveSize, sizeof(u8)) == nullptr);
+    CT_CHECK(testOOMCount == 2);
+    CT_CHECK(allocator.inUseMemory() == reserveSize, "A failed resize leaves the allocation untouched.");
+
+    CT_CHECK(allocator.calloc(1, sizeof(u8)) == nullptr);
+    CT_CHECK(testOOMCount == 3);
+
+    allocator.oomHandler = nullptr;
+    data = allocator.alloc(1, sizeof(u8));
+    CT_CHECK(data == nullptr, "Setting the oomHandler to null is not properly handled.");
+
+    return 0;
+}
+
+i32 runVirtualArenaAllocatorTestsSuite(const core::testing::TestSuiteInfo& sInfo) {
+    using namespace core::testing;
+
+    i32 ret = 0;
+
+    TestInfo tInfo = createTestInfo(sInfo);
+    tInfo.expectZeroAllocations = false;
+
+    tInfo.name = FN_NAME_TO_CPTR(virtualArenaAllocatorBasicValidityTest);
+    if (runTest(tInfo, virtualArenaAllocatorBasicValidityTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(virtualArenaAllocatorGrowLastAllocationInPlaceTest);
+    if (runTest(tInfo, virtualArenaAllocatorGrowLastAllocationInPlaceTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(virtualArenaAllocatorAlignedAllocTest);
+    if (runTest(tInfo, virtualArenaAllocatorAlignedAllocTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(virtualArenaAllocatorResetTest);
+    if (runTest(tInfo, virtualArenaAllocatorResetTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(virtualArenaAllocatorCheckpointTest);
+    if (runTest(tInfo, virtualArenaAllocatorCheckpointTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(virtualArenaAllocatorMoveTest);
+    if (runTest(tInfo, virtualArenaAllocatorMoveTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(onOomVirtualArenaAllocatorTest);
+    if (runTest(tInfo, onOomVirtualArenaAllocatorTest) != 0) { ret = -1; }
+
+    return ret;
+}
@@ -121,6 +121,21 @@ constexpr i32 pow2Test() {
     return 0;
 }
 
+constexpr i32 ispow2Test() {
+    for (u32 i = 0; i < 32; i++) {
+        CT_CHECK(core::ispow2(u32(1) << i));
+    }
+
+    CT_CHECK(!core::ispow2(0));
+    CT_CHECK(!core::ispow2(3));
+    CT_CHECK(!core::ispow2(6));
+    CT_CHECK(!core::ispow2(24));
+    CT_CHECK(!core::ispow2(1000));
+    CT_CHECK(!core::ispow2(core::limitMax<u32>()));
+
+    return 0;
+}
+
 constexpr i32 degreesTest() {
     CT_CHECK(core::degToRad(0.0f).value == 0.0f);
     CT_CHECK(core::degToRad(90.0f).value == core::piF32() / 2.0f);
@@ -525,6 +540,8 @@ i32 runMathTestsSuite(const core::testing::TestSuiteInfo& sInfo) {
     if (runTest(tInfo, pow10Test) != 0) { ret = -1; }
     tInfo.name = FN_NAME_TO_CPTR(pow2Test);
     if (runTest(tInfo, pow2Test) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(ispow2Test);
+    if (runTest(tInfo, ispow2Test) != 0) { ret = -1; }
     tInfo.name = FN_NAME_TO_CPTR(degreesTest);
     if (runTest(tInfo, degreesTest) != 0) { ret = -1; }
     tInfo.name = FN_NAME_TO_CPTR(absTest);
@@ -552,6 +569,7 @@ i32 runMathTestsSuite(const core::testing::TestSuiteInfo& sInfo) {
 constexpr i32 runCompiletimeMathTestsSuite() {
     RunTestCompileTime(pow10Test);
     RunTestCompileTime(pow2Test);
+    RunTestCompileTime(ispow2Test);
     RunTestCompileTime(degreesTest);
     RunTestCompileTime(absTest);
     RunTestCompileTime(isPositiveTest);
@@ -24,6 +24,43 @@ i32 allocateAndFreePagesTest() {
     return 0;
 }
 
+i32 reserveCommitAndDecommitPagesTest() {
+    constexpr addr_size pageCount = 8;
+    const addr_size pageSize = core::getPageSize();
+
+    u8* addr = nullptr;
+    {
+        auto res = core::reservePages(pageCount);
+        CT_CHECK(!res.hasErr());
+        CT_CHECK(res.value() != nullptr);
+        addr = static_cast<u8*>(res.value());
+    }
+    {
+        auto res = core::commitPages(addr, 2);
+        CT_CHECK(!res.hasErr());
+        addr[0] = 1;
+        addr[pageSize * 2 - 1] = 1;
+    }
+    {
+        auto res = core::decommitPages(addr, 2);
+        CT_CHECK(!res.hasErr());
+    }
+    {
+        // Committing again hands back zeroed pages.
+        auto res = core::commitPages(addr, pageCount);
+        CT_CHECK(!res.hasErr());
+        CT_CHECK(addr[0] == 0);
+        CT_CHECK(addr[pageSize * 2 - 1] == 0);
+        addr[pageSize * pageCount - 1] = 1;
+    }
+    {
+        auto res = core::freePages(addr, pageCount);
+        CT_CHECK(!res.hasErr());
+    }
+
+    return 0;
+}
+
 i32 runPltPagesTestsSuite(const core::testing::TestSuiteInfo& sInfo) {
     using namespace core::testing;
 
@@ -34,6 +71,8 @@ i32 runPltPagesTestsSuite(const core::testing::TestSuiteInfo& sInfo) {
     if(runTest(tInfo, getTheSystemPageSizeTest) != 0) { ret = -1; }
     tInfo.name = FN_NAME_TO_CPTR(allocateAndFreePagesTest);
     if(runTest(tInfo, allocateAndFreePagesTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(reserveCommitAndDecommitPagesTest);
+    if(runTest(tInfo, reserveCommitAndDecommitPagesTest) != 0) { ret = -1; }
 
     return ret;
 }
@@ -690,6 +690,28 @@ i32 convArrTest() {
     return 0;
 }
 
+template <core::AllocatorId TAllocId>
+i32 overAlignedTypeArrTest() {
+    struct alignas(64) CacheLine {
+        i32 v;
+    };
+
+    core::ArrList<CacheLine, TAllocId> arr;
+    for (i32 i = 0; i < 4; i++) {
+        arr.push(CacheLine{ i });
+        CT_CHECK(reinterpret_cast<addr_size>(arr.data()) % alignof(CacheLine) == 0);
+    }
+
+    auto cpy = arr.copy();
+    CT_CHECK(reinterpret_cast<addr_size>(cpy.data()) % alignof(CacheLine) == 0);
+    for (i32 i = 0; i < 4; i++) {
+        CT_CHECK(arr[addr_size(i)].v == i);
+        CT_CHECK(cpy[addr_size(i)].v == i);
+    }
+
+    return 0;
+}
+
 template <core::AllocatorId TAllocId>
 i32 runTests(const core::testing::TestSuiteInfo& sInfo) {
     using namespace core::testing;
@@ -723,6 +745,8 @@ i32 runTests(const core::testing::TestSuiteInfo& sInfo) {
     if (runTest(tInfo, replaceWithArrTest<TAllocId>) != 0) { return -1; }
     tInfo.name = FN_NAME_TO_CPTR(convArrTest<TAllocId>);
     if (runTest(tInfo, convArrTest<TAllocId>) != 0) { return -1; }
+    tInfo.name = FN_NAME_TO_CPTR(overAlignedTypeArrTest<TAllocId>);
+    if (runTest(tInfo, overAlignedTypeArrTest<TAllocId>) != 0) { return -1; }
 
     return 0;
 }
@@ -736,6 +760,9 @@ i32 runArrTestsSuite(const core::testing::TestSuiteInfo& sinfo) {
     if (runTests<RA_STD_STATS_ALLOCATOR_ID>(sinfo) != 0) { return -1; }
     if (runTests<RA_THREAD_LOCAL_BUMP_ALLOCATOR_ID>(sinfo) != 0) { return -1; }
     if (runTests<RA_THREAD_LOCAL_ARENA_ALLOCATOR_ID>(sinfo) != 0) { return -1; }
+    if (runTests<RA_POOL_ALLOCATOR_ID>(sinfo) != 0) { return -1; }
+    if (runTests<RA_VIRTUAL_ARENA_ALLOCATOR_ID>(sinfo) != 0) { return -1; }
+    if (runTests<RA_THREAD_CACHING_ALLOCATOR_ID>(sinfo) != 0) { return -1; }
 
     constexpr u32 BUFFER_SIZE = core::CORE_KILOBYTE * 3;
     char buf[BUFFER_SIZE];
@@ -0,0 +1,118 @@
+#include "t-index.h"
+
+i32 allocatorStatsCountRequestsTest() {
+    constexpr addr_size BUFF_SIZE = 512;
+    u8 buff[BUFF_SIZE] = {};
+    core::BumpAllocator allocator(buff, BUFF_SIZE);
+    core::AllocatorStatsCounters counters = {};
+    core::AllocatorContext actx = core::createAllocatorCtx(&allocator);
+    CT_CHECK(!actx.hasStats());
+    actx.statsCounters = &counters;
+    CT_CHECK(actx.hasStats());
+
+    void* a = actx.alloc(10, sizeof(u8));
+    void* b = actx.zeroAlloc(25, sizeof(u32));
+    CT_CHECK(a != nullptr && b != nullptr);
+
+    {
+        core::AllocatorStats stats = actx.stats();
+        CT_CHECK(stats.allocCount == 2);
+        CT_CHECK(stats.inUseBytes == 110);
+        CT_CHECK(stats.peakInUseBytes == 110);
+        CT_CHECK(stats.sizeHistogram[4] == 1, "10 bytes fall in (8, 16]");
+        CT_CHECK(stats.sizeHistogram[7] == 1, "100 bytes fall in (64, 128]");
+    }
+
+    // The last allocation of a bump allocator grows in place, anything else is copied.
+    void* grown = actx.reallocate(b, 50, sizeof(u32), 25, sizeof(u32));
+    CT_CHECK(grown == b);
+    void* moved = actx.reallocate(a, 20, sizeof(u8), 10, sizeof(u8));
+    CT_CHECK(moved != a);
+
+    {
+        core::AllocatorStats stats = actx.stats();
+        CT_CHECK(stats.reallocCount == 2);
+        CT_CHECK(stats.reallocCopyCount == 1);
+        CT_CHECK(stats.inUseBytes == 220);
+        CT_CHECK(stats.peakInUseBytes == 220);
+    }
+
+    actx.free(moved, 20, sizeof(u8));
+    actx.free(grown, 50, sizeof(u32));
+    actx.free(nullptr, 1, 1); // not counted
+
+    {
+        core::AllocatorStats stats = actx.stats();
+        CT_CHECK(stats.freeCount == 2);
+        CT_CHECK(stats.inUseBytes == 0);
+        CT_CHECK(stats.peakInUseBytes == 220, "The peak stays after the memory is freed.");
+    }
+
+    allocator.oomHandler = nullptr;
+    CT_CHECK(actx.alloc(BUFF_SIZE * 2, sizeof(u8)) == nullptr);
+    CT_CHECK(actx.stats().failedAllocCount == 1);
+    CT_CHECK(actx.stats().allocCount == 2, "Failed requests are not counted as allocations.");
+
+    return 0;
+}
+
+i32 allocatorStatsResetKeepsInUseBytesTest() {
+    core::StdAllocator allocator;
+    core::AllocatorStatsCounters counters = {};
+    core::AllocatorContext actx = core::createAllocatorCtx(&allocator);
+    actx.statsCounters = &counters;
+
+    void* a = actx.alloc(64, sizeof(u8));
+    void* b = actx.alloc(64, sizeof(u8));
+    actx.free(b, 64, sizeof(u8));
+
+    actx.resetStats();
+    core::AllocatorStats stats = actx.stats();
+    CT_CHECK(stats.allocCount == 0);
+    CT_CHECK(stats.freeCount == 0);
+    CT_CHECK(stats.sizeHistogram[6] == 0);
+    CT_CHECK(stats.inUseBytes == 64);
+    CT_CHECK(stats.peakInUseBytes == 64);
+
+    actx.free(a, 64, sizeof(u8));
+    CT_CHECK(actx.stats().inUseBytes == 0);
+
+    return 0;
+}
+
+i32 registeredAllocatorsCollectStatsTest() {
+    CT_CHECK(core::getAllocator(core::DEFAULT_ALLOCATOR_ID).hasStats());
+
+    auto& actx = core::getAllocator(RA_STD_STATS_ALLOCATOR_ID);
+    CT_CHECK(actx.hasStats());
+
+    core::AllocatorStats before = actx.stats();
+    void* ptr = actx.alloc(3000, sizeof(u8));
+    CT_CHECK(ptr != nullptr);
+    CT_CHECK(actx.stats().peakInUseBytes >= before.inUseBytes + 3000);
+    actx.free(ptr, 3000, sizeof(u8));
+
+    core::AllocatorStats after = actx.stats();
+    CT_CHECK(after.allocCount == before.allocCount + 1);
+    CT_CHECK(after.freeCount == before.freeCount + 1);
+    CT_CHECK(after.sizeHistogram[12] == before.sizeHistogram[12] + 1);
+    CT_CHECK(after.inUseBytes == before.inUseBytes);
+
+    return 0;
+}
+
+i32 runExecCtxTestsSuite(const core::testing::TestSuiteInfo& sInfo) {
+    using namespace core::testing;
+
+    i32 ret = 0;
+    TestInfo tInfo = createTestInfo(sInfo);
+
+    tInfo.name = FN_NAME_TO_CPTR(allocatorStatsCountRequestsTest);
+    if (runTest(tInfo, allocatorStatsCountRequestsTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(allocatorStatsResetKeepsInUseBytesTest);
+    if (runTest(tInfo, allocatorStatsResetKeepsInUseBytesTest) != 0) { ret = -1; }
+    tInfo.name = FN_NAME_TO_CPTR(registeredAllocatorsCollectStatsTest);
+    if (runTest(tInfo, registeredAllocatorsCollectStatsTest) != 0) { ret = -1; }
+
+    return ret;
+}
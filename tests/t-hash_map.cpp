@@ -643,6 +643,27 @@ constexpr i32 hashMapTraitsTest() {
     return 0;
 }
 
+template <core::AllocatorId TAllocId>
+i32 overAlignedValuesInHashMapTest() {
+    struct alignas(32) Vec4 {
+        f64 x, y, z, w;
+    };
+
+    core::HashMap<i32, Vec4, TAllocId> m;
+    for (i32 i = 0; i < 40; i++) {
+        Vec4* v = m.put(i, Vec4{ f64(i), 0, 0, 0 });
+        CT_CHECK(reinterpret_cast<addr_size>(v) % alignof(Vec4) == 0);
+    }
+
+    for (i32 i = 0; i < 40; i++) {
+        const Vec4* v = m.get(i);
+        CT_CHECK(v != nullptr);
+        CT_CHECK(v->x == f64(i));
+    }
+
+    return 0;
+}
+
 template <core::AllocatorId TAllocId>
 i32 runTests(const core::testing::TestSuiteInfo& sInfo) {
     using namespace core::testing;
@@ -671,6 +692,8 @@ i32 runTests(const core::testing::TestSuiteInfo& sInfo) {
     if (runTest(tInfo, earlyStopIterationsTest<TAllocId>) != 0) { return -1; }
     tInfo.name = FN_NAME_TO_CPTR(chainBrakeBugTest);
     if (runTest(tInfo, chainBrakeBugTest<TAllocId>) != 0) { return -1; }
+    tInfo.name = FN_NAME_TO_CPTR(overAlignedValuesInHashMapTest);
+    if (runTest(tInfo, overAlignedValuesInHashMapTest<TAllocId>) != 0) { return -1; }
 
     return 0;
 }
@@ -684,6 +707,9 @@ i32 runHashMapTestsSuite(const core::testing::TestSuiteInfo& sInfo) {
     if (runTests<RA_STD_STATS_ALLOCATOR_ID>(sInfo) != 0) { return -1; }
     if (runTests<RA_THREAD_LOCAL_BUMP_ALLOCATOR_ID>(sInfo) != 0) { return -1; }
     if (runTests<RA_THREAD_LOCAL_ARENA_ALLOCATOR_ID>(sInfo) != 0) { return -1; }
+    if (runTests<RA_POOL_ALLOCATOR_ID>(sInfo) != 0) { return -1; }
+    if (runTests<RA_VIRTUAL_ARENA_ALLOCATOR_ID>(sInfo) != 0) { return -1; }
+    if (runTests<RA_THREAD_CACHING_ALLOCATOR_ID>(sInfo) != 0) { return -1; }
 
     constexpr u32 BUFFER_SIZE = core::CORE_MEGABYTE / 2;
     char buf[BUFFER_SIZE];
@@ -25,6 +25,9 @@ enum RegisteredAllocators : core::AllocatorId {
     RA_ARENA_ALLOCATOR_ID,
     RA_THREAD_LOCAL_BUMP_ALLOCATOR_ID,
     RA_THREAD_LOCAL_ARENA_ALLOCATOR_ID,
+    RA_POOL_ALLOCATOR_ID,
+    RA_VIRTUAL_ARENA_ALLOCATOR_ID,
+    RA_THREAD_CACHING_ALLOCATOR_ID,
 
     RA_SENTINEL
 };
@@ -45,6 +48,7 @@ i32 runCstrConv_FloatToCstr_TestsSuite(const core::testing::TestSuiteInfo& sInfo
 i32 verifyRyuAlgorithm(const core::testing::TestSuiteInfo& sInfo);
 i32 runCstrTestsSuite(const core::testing::TestSuiteInfo& sInfo);
 i32 runDeferTestsSuite(const core::testing::TestSuiteInfo& sInfo);
+i32 runExecCtxTestsSuite(const core::testing::TestSuiteInfo& sInfo);
 i32 runExpectedTestsSuite(const core::testing::TestSuiteInfo& sInfo);
 i32 runHashMapTestsSuite(const core::testing::TestSuiteInfo& sInfo);
 i32 runHashTestsSuite(const core::testing::TestSuiteInfo& sInfo);
@@ -69,6 +73,10 @@ i32 runBumpAllocatorTestsSuite(const core::testing::TestSuiteInfo& sInfo);
 i32 runStdAllocatorTestsSuite(const core::testing::TestSuiteInfo& sInfo);
 i32 runStdStatsAllocatorTestsSuite(const core::testing::TestSuiteInfo& sInfo);
 i32 runArenaAllocatorTestsSuite(const core::testing::TestSuiteInfo& sInfo);
+i32 runPoolAllocatorTestsSuite(const core::testing::TestSuiteInfo& sInfo);
+i32 runVirtualArenaAllocatorTestsSuite(const core::testing::TestSuiteInfo& sInfo);
+i32 runThreadCachingAllocatorTestsSuite(const core::testing::TestSuiteInfo& sInfo);
+i32 runTracingAllocatorTestsSuite(const core::testing::TestSuiteInfo& sInfo);
 
 i32 runPltErrorTestsSuite(const core::testing::TestSuiteInfo& sInfo);
 i32 runPltFileSystemTestsSuite(const core::testing::TestSuiteInfo& sInfo);
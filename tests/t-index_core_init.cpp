@@ -42,6 +42,10 @@ static auto g_threadLocalBumpAllocator = core::ThreadLocalBumpAllocator::create(
 constexpr addr_size THREAD_LOCAL_ARENA_ALLOCATOR_REGION_SIZE = core::CORE_MEGABYTE;
 static auto g_threadLocalArenaAllocator = core::ThreadLocalStdArenaAllocator::create(THREAD_LOCAL_ARENA_ALLOCATOR_REGION_SIZE);
 
+static core::PoolAllocator g_poolAllocator;
+static core::VirtualArenaAllocator g_virtualArenaAllocator;
+static core::ThreadCachingAllocator g_threadCachingAllocator;
+
 void coreInit() {
     core::initProgramCtx(assertHandler, nullptr, core::createAllocatorCtx(&g_defaultAllocator));
 
@@ -51,6 +55,9 @@ void coreInit() {
     core::registerAllocator(core::createAllocatorCtx(&g_arenaAllocator), RA_ARENA_ALLOCATOR_ID);
     core::registerAllocator(core::createAllocatorCtx(&g_threadLocalBumpAllocator), RA_THREAD_LOCAL_BUMP_ALLOCATOR_ID);
     core::registerAllocator(core::createAllocatorCtx(&g_threadLocalArenaAllocator), RA_THREAD_LOCAL_ARENA_ALLOCATOR_ID);
+    core::registerAllocator(core::createAllocatorCtx(&g_poolAllocator), RA_POOL_ALLOCATOR_ID);
+    core::registerAllocator(core::createAllocatorCtx(&g_virtualArenaAllocator), RA_VIRTUAL_ARENA_ALLOCATOR_ID);
+    core::registerAllocator(core::createAllocatorCtx(&g_threadCachingAllocator), RA_THREAD_CACHING_ALLOCATOR_ID);
 }
 
 void coreShutdown() {
@@ -101,6 +108,8 @@ i32 runAllTests() {
     if (runTestSuite(sInfo, runCstrTestsSuite) != 0) { ret = -1; }
     sInfo.name = FN_NAME_TO_CPTR(runDeferTestsSuite);
     if (runTestSuite(sInfo, runDeferTestsSuite) != 0) { ret = -1; }
+    sInfo.name = FN_NAME_TO_CPTR(runExecCtxTestsSuite);
+    if (runTestSuite(sInfo, runExecCtxTestsSuite) != 0) { ret = -1; }
     sInfo.name = FN_NAME_TO_CPTR(runExpectedTestsSuite);
     if (runTestSuite(sInfo, runExpectedTestsSuite) != 0) { ret = -1; }
     sInfo.name = FN_NAME_TO_CPTR(runHashMapTestsSuite);
@@ -148,6 +157,14 @@ i32 runAllTests() {
     if (runTestSuite(sInfo, runStdStatsAllocatorTestsSuite) != 0) { ret = -1; }
     sInfo.name = FN_NAME_TO_CPTR(runArenaAllocatorTestsSuite);
     if (runTestSuite(sInfo, runArenaAllocatorTestsSuite) != 0) { ret = -1; }
+    sInfo.name = FN_NAME_TO_CPTR(runPoolAllocatorTestsSuite);
+    if (runTestSuite(sInfo, runPoolAllocatorTestsSuite) != 0) { ret = -1; }
+    sInfo.name = FN_NAME_TO_CPTR(runVirtualArenaAllocatorTestsSuite);
+    if (runTestSuite(sInfo, runVirtualArenaAllocatorTestsSuite) != 0) { ret = -1; }
+    sInfo.name = FN_NAME_TO_CPTR(runThreadCachingAllocatorTestsSuite);
+    if (runTestSuite(sInfo, runThreadCachingAllocatorTestsSuite) != 0) { ret = -1; }
+    sInfo.name = FN_NAME_TO_CPTR(runTracingAllocatorTestsSuite);
+    if (runTestSuite(sInfo, runTracingAllocatorTestsSuite) != 0) { ret = -1; }
 
     // Run platform specific tests:
 
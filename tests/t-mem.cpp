@@ -37,6 +37,31 @@ constexpr i32 alignTest() {
     });
     CT_CHECK(ret == 0);
 
+    struct TestCaseWithAlignment {
+        addr_size in;
+        u32 alignment;
+        addr_size expected;
+    };
+
+    constexpr TestCaseWithAlignment casesWithAlignment[] = {
+        { 0, 1, 0 },
+        { 7, 1, 7 },
+        { 1, 16, 16 },
+        { 16, 16, 16 },
+        { 17, 64, 64 },
+        { 65, 64, 128 },
+        { 4097, 4096, 8192 },
+        { 0x100000001, 16, 0x100000010 },
+        { 0x7fffffff00000001, 4096, 0x7fffffff00001000 },
+    };
+
+    ret = core::testing::executeTestTable("test case failed at index: ", casesWithAlignment, [](auto& c, const char* cErr) {
+        auto got = core::align(c.in, c.alignment);
+        CT_CHECK(got == c.expected, cErr);
+        return 0;
+    });
+    CT_CHECK(ret == 0);
+
     return 0;
 }
 
@@ -169,6 +169,9 @@ i32 runStackTestsSuite(const core::testing::TestSuiteInfo& sInfo) {
     if (runStackTests<RA_STD_STATS_ALLOCATOR_ID>(sInfo) != 0) { return -1; }
     if (runStackTests<RA_THREAD_LOCAL_BUMP_ALLOCATOR_ID>(sInfo) != 0) { return -1; }
     if (runStackTests<RA_THREAD_LOCAL_ARENA_ALLOCATOR_ID>(sInfo) != 0) { return -1; }
+    if (runStackTests<RA_POOL_ALLOCATOR_ID>(sInfo) != 0) { return -1; }
+    if (runStackTests<RA_VIRTUAL_ARENA_ALLOCATOR_ID>(sInfo) != 0) { return -1; }
+    if (runStackTests<RA_THREAD_CACHING_ALLOCATOR_ID>(sInfo) != 0) { return -1; }
 
     constexpr u32 BUFFER_SIZE = core::CORE_KILOBYTE * 3;
     char buf[BUFFER_SIZE];
@@ -397,6 +397,9 @@ i32 runStrBuilderTestsSuite(const core::testing::TestSuiteInfo& sInfo) {
     if (runTests<RA_STD_STATS_ALLOCATOR_ID>(sInfo) != 0) { return -1; }
     if (runTests<RA_THREAD_LOCAL_BUMP_ALLOCATOR_ID>(sInfo) != 0) { return -1; }
     if (runTests<RA_THREAD_LOCAL_ARENA_ALLOCATOR_ID>(sInfo) != 0) { return -1; }
+    if (runTests<RA_POOL_ALLOCATOR_ID>(sInfo) != 0) { return -1; }
+    if (runTests<RA_VIRTUAL_ARENA_ALLOCATOR_ID>(sInfo) != 0) { return -1; }
+    if (runTests<RA_THREAD_CACHING_ALLOCATOR_ID>(sInfo) != 0) { return -1; }
 
     constexpr u32 BUFFER_SIZE = core::CORE_KILOBYTE * 3;
     char buf[BUFFER_SIZE];